@@ -0,0 +1,20 @@
+# Every shader permutation packed into the shader archive. The runtime looks them up
+# by NAME, e.g. add_shader_permutation(simple_alpha SOURCE simple.slang
+# ENTRIES vert_main frag_main DEFINES ALPHA_TEST=1)
+
+add_shader_permutation(simple
+    SOURCE simple.slang
+    ENTRIES vert_main frag_main
+)
+
+# Mesh shading path, only loaded on devices with VK_EXT_mesh_shader.
+add_shader_permutation(meshlet
+    SOURCE meshlet.slang
+    ENTRIES task_main mesh_main frag_main
+)
+
+add_shader_permutation(meshlet_quantized
+    SOURCE meshlet.slang
+    ENTRIES task_main mesh_main frag_main
+    DEFINES QUANTIZED_VERTICES=1
+)
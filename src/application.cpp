@@ -1,20 +1,119 @@
 #include "application.hpp"
+#include "assets/lod_selection.hpp"
+#include "assets/mesh_format.hpp"
+#include "assets/shader_reflection.hpp"
+#include "assets/vertex_quantization.hpp"
+#include "utils/inline_vector.hpp"
+#include "utils/profiler.hpp"
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <format>
+#include <iostream>
+#include <numbers>
+#include <numeric>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <span>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace {
 
 constexpr uint32_t NUM_FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t NUM_STREAMING_THREADS = 2;
+// Meshes baked with --no-optimize get reordered while streaming in.
+constexpr bool OPTIMIZE_MESHES_ON_LOAD = true;
+// Records and submits frames on a thread of their own while the next frame is simulated.
+constexpr bool USE_RENDER_THREAD = true;
+constexpr VkDeviceSize STREAMING_BYTE_BUDGET = 16 * 1024 * 1024;
+
+// Zones are recorded from the start, T writes the last few seconds out.
+constexpr bool ENABLE_PROFILER = true;
+constexpr const char* TRACE_FILENAME = "trace.json";
+// GPU timestamps of each frame: start, after the streaming uploads, end.
+constexpr uint32_t GPU_TIMESTAMP_COUNT = 3;
+
+// Instances animated or queued for drawing by one job.
+constexpr uint32_t INSTANCE_JOB_SIZE = 4096;
+
+// Specialization constant IDs declared in simple.slang and meshlet.slang.
+constexpr uint32_t SIMPLE_USE_VERTEX_COLOR = 0;
+
+// Meshlets culled by one task shader workgroup in meshlet.slang.
+constexpr uint32_t MESHLET_TASK_GROUP_SIZE = 32;
+
+// The camera looks at the scene down +z from above, with y pointing down the screen the
+// way meshes used to be drawn straight as clip space. Distances are in scene radii.
+constexpr float CAMERA_FOV_Y = glm::radians(60.0f);
+constexpr float CAMERA_ZOOM_STEP = 1.25f;
+constexpr float MIN_CAMERA_DISTANCE = 0.01f;
+constexpr float MAX_CAMERA_DISTANCE = 100.0f;
+constexpr float CAMERA_ELEVATION = glm::radians(30.0f);
+
+// Coarser LODs are drawn as long as their error stays under a pixel.
+constexpr float LOD_MAX_PIXEL_ERROR = 1.0f;
+
+// Synthetic scene drawn with the loaded mesh: a grid of spinning objects, each carrying
+// smaller children that orbit it. Lengths are in mesh bounding sphere radii.
+constexpr uint32_t SCENE_GRID_SIZE = 128;
+constexpr uint32_t SCENE_CHILD_COUNT = 2;
+constexpr float SCENE_GRID_SPACING = 6.0f;
+constexpr float SCENE_CHILD_DISTANCE = 2.0f;
+constexpr float SCENE_CHILD_SCALE = 0.4f;
+// Radians per second.
+constexpr float SCENE_SPIN_SPEED = 0.5f;
+
+// Shaders read FrameConstants at the start of the frame buffer, followed by the scene
+// instances and the instance indices sorted by LOD.
+constexpr VkDeviceSize FRAME_INSTANCES_OFFSET = 256;
+
+// Task shader dispatches are limited by maxTaskWorkGroupCount and
+// maxTaskWorkGroupTotalCount, these are the minimums every device supports.
+constexpr uint32_t MAX_TASK_GROUP_COUNT = 65535;
+constexpr uint32_t MAX_TASK_GROUP_TOTAL_COUNT = 1u << 22;
+
+struct FrameConstants {
+    glm::mat4 view_projection;
+    glm::vec4 camera_position;
+};
+static_assert(sizeof(FrameConstants) <= FRAME_INSTANCES_OFFSET);
+
+// Push constants of the simple permutations. instance_indices point at the indices of the
+// drawn batch, quantized meshes decode their positions with position_offset and position_scale.
+struct DrawConstants {
+    VkDeviceAddress frame;
+    VkDeviceAddress instances;
+    VkDeviceAddress instance_indices;
+    uint64_t padding;
+    glm::vec4 position_offset;
+    glm::vec4 position_scale;
+};
+
+// Push constants of the meshlet permutations.
+struct MeshletDrawConstants {
+    VkDeviceAddress meshlets;
+    VkDeviceAddress meshlet_vertices;
+    VkDeviceAddress meshlet_triangles;
+    VkDeviceAddress vertices;
+    VkDeviceAddress frame;
+    VkDeviceAddress instances;
+    VkDeviceAddress instance_indices;
+    uint64_t padding;
+    glm::vec4 position_offset;
+    glm::vec4 position_scale;
+    uint32_t meshlet_count;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(MeshletDrawConstants) <= 128);
 
 std::vector<const char*> get_required_instance_extensions() {
     uint32_t sdl_vk_extensions_count = 0;
@@ -54,50 +153,47 @@ const std::vector<const char*> required_device_extensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
-void transition_image_layout(VkCommandBuffer cmd_buffer,
-                             VkImage image,
-                             VkImageLayout old_layout,
-                             VkImageLayout new_layout,
-                             VkAccessFlags2 src_access,
-                             VkAccessFlags2 dst_access,
-                             VkPipelineStageFlags2 src_stage,
-                             VkPipelineStageFlags2 dst_stage) {
-    VkImageMemoryBarrier2 barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-    barrier.srcStageMask = src_stage;
-    barrier.srcAccessMask = src_access;
-    barrier.dstStageMask = dst_stage;
-    barrier.dstAccessMask = dst_access;
-    barrier.oldLayout = old_layout;
-    barrier.newLayout = new_layout;
-    barrier.image = image;
-    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
-    VkDependencyInfo deps_info = {};
-    deps_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-    deps_info.imageMemoryBarrierCount = 1;
-    deps_info.pImageMemoryBarriers = &barrier;
-    vkCmdPipelineBarrier2(cmd_buffer, &deps_info);
-}
-
-struct Vertex {
-    glm::vec2 position;
-    glm::vec3 color;
-};
+using Vertex = assets::MeshVertex;
 
+// Drawn when no mesh file is given on the command line.
 const std::array<Vertex, 4> vertices = {
-    Vertex{ { -0.5f, -0.5f }, { 1.0f, 0.0f, 0.0f } },
-    Vertex{ {  0.5f, -0.5f }, { 0.0f, 1.0f, 0.0f } },
-    Vertex{ {  0.5f,  0.5f }, { 0.0f, 0.0f, 1.0f } },
-    Vertex{ { -0.5f,  0.5f }, { 1.0f, 1.0f, 0.0f } }
+    Vertex{ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+    Vertex{ {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+    Vertex{ {  0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+    Vertex{ { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f } }
 };
 
 const std::array<uint16_t, 6> indices = {
     0, 1, 2, 2, 3, 0
 };
 
+// Shader locations of the vertex fields. Formats of the float layout come from reflection,
+// the quantized one overrides them with its packed formats.
+const std::array<assets::VertexAttributeSource, 2> vertex_sources = { {
+    { .location = 0, .binding = 0, .offset = offsetof(Vertex, position) },
+    { .location = 1, .binding = 0, .offset = offsetof(Vertex, color) }
+} };
+
+const std::array<assets::VertexAttributeSource, 2> quantized_vertex_sources = { {
+    { .location = 0, .binding = 0, .offset = offsetof(assets::QuantizedMeshVertex, position), .format = VK_FORMAT_R16G16B16A16_SNORM },
+    { .location = 1, .binding = 0, .offset = offsetof(assets::QuantizedMeshVertex, color), .format = VK_FORMAT_R8G8B8A8_UNORM }
+} };
+
+const char* get_permutation_name(assets::VertexFormat vertex_format, bool mesh_shading) {
+    const bool is_quantized = vertex_format == assets::VertexFormat::Quantized;
+    if (mesh_shading) {
+        return is_quantized ? "meshlet_quantized" : "meshlet";
+    }
+
+    // The vertex path decodes both formats with the same shader, through the position
+    // offset and scale in the draw constants.
+    return "simple";
+}
+
 }
 
-Application::Application() :
+Application::Application(const char* mesh_filename) :
+    job_system_{ std::max(std::thread::hardware_concurrency(), 2u) - 1 },
     window_{ SDL_CreateWindow(app_info.pApplicationName,
                               1440, 900,
                               SDL_WINDOW_VULKAN | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_RESIZABLE),
@@ -109,14 +205,23 @@ Application::Application() :
     vk_staging_cmd_pool_{ vk_device_, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, vk_queue_family_index_ },
     vk_cmd_pool_{ vk_device_, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, vk_queue_family_index_ },
     vk_memory_allocator_{ vk_instance_, vk_device_, app_info.apiVersion },
+    shader_archive_{ "shaders/shaders.vsha" },
+    vk_shader_library_{ vk_device_ },
     vk_surface_caps_{ vk_device_.get_physical_device().get_surface_capabilities(vk_surface_) },
     vk_surface_format_{ choose_swapchain_surface_format() },
+    vk_depth_format_{ choose_depth_format() },
     vk_swapchain_{ create_swapchain() },
-    vk_pipeline_{ create_pipeline() },
-    vk_vertex_buffer_{ vk_memory_allocator_, vertices.size() * sizeof(Vertex),
-                       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0 },
-    vk_index_buffer_{ vk_memory_allocator_, indices.size() * sizeof(uint16_t),
-                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0 },
+    vk_depth_image_{ create_depth_image() },
+    vk_depth_image_view_{ vk_device_, vk_depth_image_, vk_depth_format_, VK_IMAGE_ASPECT_DEPTH_BIT },
+    vk_mesh_pipelines_{ create_mesh_pipelines(assets::VertexFormat::Float32, false),
+                        create_mesh_pipelines(assets::VertexFormat::Quantized, false) },
+    vk_meshlet_pipelines_{ create_meshlet_pipelines() },
+    asset_streamer_{ vk_device_,
+                     vk_memory_allocator_,
+                     vk_resources_,
+                     NUM_STREAMING_THREADS,
+                     (OPTIMIZE_MESHES_ON_LOAD ? assets::AssetStreamer::OPTIMIZE_MESHES : 0u) |
+                     (mesh_shading_supported_ ? assets::AssetStreamer::LOAD_MESHLETS : 0u) },
     vk_cmd_buffers_{ vk_cmd_pool_.allocate_command_buffers(NUM_FRAMES_IN_FLIGHT) }
 {
     // TODO(Kostu): this check happens too late, need to wrap SDL_Window for this
@@ -124,6 +229,17 @@ Application::Application() :
         throw std::runtime_error(std::format("Window creation failed: {}", SDL_GetError()));
     }
 
+    profiler::set_enabled(ENABLE_PROFILER);
+    profiler::set_thread_name("Main");
+
+    // Queues without timestamp support leave the GPU track empty.
+    const auto& physical_device = vk_device_.get_physical_device();
+    if (physical_device.get_queue_family_properties()[vk_queue_family_index_].timestampValidBits > 0) {
+        vk_timestamp_pool_.emplace(vk_device_, VK_QUERY_TYPE_TIMESTAMP, NUM_FRAMES_IN_FLIGHT * GPU_TIMESTAMP_COUNT);
+        gpu_timestamp_period_ = physical_device.get_properties().limits.timestampPeriod;
+    }
+    gpu_submit_times_.resize(NUM_FRAMES_IN_FLIGHT, 0);
+
     for (uint32_t i = 0; i < vk_swapchain_.get_image_count(); ++i) {
         vk_render_semaphores_.emplace_back(vk_device_);
     }
@@ -132,67 +248,266 @@ Application::Application() :
         vk_draw_fences_.emplace_back(vk_device_, true);
     }
 
-    VkDeviceSize vertex_buffer_size = vk_vertex_buffer_.get_size();
-    vlk::Buffer vertex_staging_buffer{ vk_memory_allocator_,
-                                       vertex_buffer_size,
-                                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                       VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT };
-    vertex_staging_buffer.copy_memory_to_allocation(vertices.data(), vertex_buffer_size);
+    // The built-in quad is shown until the requested mesh finishes streaming in.
+    if (mesh_filename != nullptr) {
+        asset_streamer_.request_mesh(mesh_filename, 1.0f);
+    }
 
-    VkDeviceSize index_buffer_size = vk_index_buffer_.get_size();
-    vlk::Buffer index_staging_buffer{ vk_memory_allocator_,
-                                      index_buffer_size,
-                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT };
-    index_staging_buffer.copy_memory_to_allocation(indices.data(), index_buffer_size);
+    const auto vertex_data = std::as_bytes(std::span{ vertices });
+    const auto index_data = std::as_bytes(std::span{ indices });
+    mesh_.lods = { {
+        .index_offset = 0,
+        .index_count = static_cast<uint32_t>(indices.size()),
+        .meshlet_offset = 0,
+        .meshlet_count = 0,
+        .error = 0.0f,
+        .reserved = {}
+    } };
+    for (const auto& vertex : vertices) {
+        mesh_.bounds_min = glm::min(mesh_.bounds_min, vertex.position);
+        mesh_.bounds_max = glm::max(mesh_.bounds_max, vertex.position);
+    }
 
-    auto staging_cmd_buffers = vk_staging_cmd_pool_.allocate_command_buffers(1);
+    auto& vk_buffers = vk_resources_.get_buffers();
+    mesh_.vertex_buffer = vk_buffers.create(vk_memory_allocator_,
+                                            vertex_data.size(),
+                                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            vlk::Buffer::UPLOAD_FLAGS);
+    mesh_.index_buffer = vk_buffers.create(vk_memory_allocator_,
+                                           index_data.size(),
+                                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                           vlk::Buffer::UPLOAD_FLAGS);
+
+    // With ReBAR the geometry buffers are mapped and written directly, otherwise go through staging.
+    std::optional<vlk::Buffer> vertex_staging_buffer;
+    std::optional<vlk::Buffer> index_staging_buffer;
+    upload_buffer(vk_buffers[mesh_.vertex_buffer], vertex_data, vertex_staging_buffer);
+    upload_buffer(vk_buffers[mesh_.index_buffer], index_data, index_staging_buffer);
+
+    if (vertex_staging_buffer || index_staging_buffer) {
+        auto staging_cmd_buffers = vk_staging_cmd_pool_.allocate_command_buffers(1);
+
+        auto& staging_cmd_buffer = staging_cmd_buffers[0];
+        staging_cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        if (vertex_staging_buffer) {
+            staging_cmd_buffer.copy_buffer(*vertex_staging_buffer, vk_buffers[mesh_.vertex_buffer]);
+        }
+        if (index_staging_buffer) {
+            staging_cmd_buffer.copy_buffer(*index_staging_buffer, vk_buffers[mesh_.index_buffer]);
+        }
+        staging_cmd_buffer.end();
 
-    auto& staging_cmd_buffer = staging_cmd_buffers[0];
-    staging_cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    staging_cmd_buffer.copy_buffer(vertex_staging_buffer, vk_vertex_buffer_);
-    staging_cmd_buffer.copy_buffer(index_staging_buffer, vk_index_buffer_);
-    staging_cmd_buffer.end();
+        vk_queue_.submit(staging_cmd_buffer);
+        vk_queue_.wait_idle();
 
-    vk_queue_.submit(staging_cmd_buffer);
-    vk_queue_.wait_idle();
+        vk_staging_cmd_pool_.free_command_buffers(staging_cmd_buffers);
+    }
 
-    vk_staging_cmd_pool_.free_command_buffers(staging_cmd_buffers);
+    // The scene keeps its size across meshes, so the frame buffers are made once.
+    scene_mesh_ = mesh_;
+    build_scene();
+    const VkDeviceSize frame_buffer_size = FRAME_INSTANCES_OFFSET +
+                                           scene_.get_object_count() * (sizeof(scene::InstanceData) + sizeof(uint32_t));
+    for (uint32_t i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i) {
+        vk_frame_buffers_.emplace_back(vk_memory_allocator_,
+                                       frame_buffer_size,
+                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                       vlk::Buffer::DYNAMIC_FLAGS);
+    }
+
+    if (USE_RENDER_THREAD) {
+        render_thread_ = std::jthread{ [this](std::stop_token stop_token) { render_main(stop_token); } };
+    }
 }
 
 Application::~Application() {
+    if (render_thread_.joinable()) {
+        render_thread_.request_stop();
+        published_packet_count_.fetch_add(1);
+        published_packet_count_.notify_one();
+        render_thread_.join();
+    }
+
     vk_device_.wait_idle();
 }
 
 void Application::update() {
-    static uint32_t frame_index = 0;
+    PROFILE_ZONE("update");
+
+    // Stay at most one packet ahead: the next frame is simulated while the render thread
+    // draws the last one published.
+    const uint64_t published_count = published_packet_count_.load();
+    if (render_thread_.joinable()) {
+        PROFILE_ZONE("wait_for_render_thread");
+        for (uint64_t acquired_count = acquired_packet_count_.load(); acquired_count < published_count; acquired_count = acquired_packet_count_.load()) {
+            acquired_packet_count_.wait(acquired_count);
+        }
+
+        std::lock_guard lock{ render_error_mutex_ };
+        if (render_error_) {
+            std::rethrow_exception(render_error_);
+        }
+    }
+
+    simulate(packets_.get_write_slot());
+    packets_.publish();
+    published_packet_count_.store(published_count + 1);
+
+    if (render_thread_.joinable()) {
+        published_packet_count_.notify_one();
+        return;
+    }
+
+    packets_.acquire();
+    acquired_packet_count_.store(published_count + 1);
+    render(packets_.get_read_slot());
+}
+
+void Application::render_main(std::stop_token stop_token) {
+    profiler::set_thread_name("Render");
+    try {
+        uint64_t acquired_count = 0;
+        while (true) {
+            published_packet_count_.wait(acquired_count);
+            if (stop_token.stop_requested()) {
+                return;
+            }
+
+            packets_.acquire();
+            acquired_count = published_packet_count_.load();
+            acquired_packet_count_.store(acquired_count);
+            acquired_packet_count_.notify_one();
+
+            render(packets_.get_read_slot());
+        }
+    }
+    catch (...) {
+        {
+            std::lock_guard lock{ render_error_mutex_ };
+            render_error_ = std::current_exception();
+        }
+        // Releases update() to rethrow the error.
+        acquired_packet_count_.store(std::numeric_limits<uint64_t>::max());
+        acquired_packet_count_.notify_one();
+    }
+}
+
+void Application::render(const FramePacket& packet) {
+    PROFILE_ZONE("render");
+
+    const uint32_t frame_index = frame_number_ % NUM_FRAMES_IN_FLIGHT;
 
-    vk_draw_fences_[frame_index].wait();
+    {
+        PROFILE_ZONE("wait_for_fence");
+        vk_draw_fences_[frame_index].wait();
+    }
+    read_gpu_timestamps(frame_index);
+
+    // Waiting on this slot's fence means the frame submitted NUM_FRAMES_IN_FLIGHT ago has finished.
+    if (frame_number_ >= NUM_FRAMES_IN_FLIGHT) {
+        vk_resources_.collect(frame_number_ - NUM_FRAMES_IN_FLIGHT);
+    }
 
-    auto next_image = vk_swapchain_.acquire_next_image(vk_present_semaphores_[frame_index]);
+    vlk::Swapchain::NextImage next_image;
+    {
+        PROFILE_ZONE("acquire_image");
+        next_image = vk_swapchain_.acquire_next_image(vk_present_semaphores_[frame_index]);
+    }
     if (next_image.should_recreate_swapchain) {
-        vk_swapchain_ = create_swapchain();
+        recreate_swapchain();
         return;
     }
 
+    if (packet.settings.use_vertex_color != use_vertex_color_) {
+        // Variants seen before come straight out of the registry's pipeline cache.
+        use_vertex_color_ = packet.settings.use_vertex_color;
+        for (auto& pipelines : vk_mesh_pipelines_) {
+            create_pipeline_variants(pipelines);
+        }
+        if (vk_meshlet_pipelines_) {
+            for (auto& pipelines : *vk_meshlet_pipelines_) {
+                create_pipeline_variants(pipelines);
+            }
+        }
+    }
+
     const auto& current_cmd_buffer = vk_cmd_buffers_[frame_index];
-    record_cmd_buffer(current_cmd_buffer, next_image.image, next_image.image_view);
+    write_gpu_timestamps_ = vk_timestamp_pool_ && profiler::is_enabled();
+    {
+        PROFILE_ZONE("record");
+        record_cmd_buffer(current_cmd_buffer, next_image.image, next_image.image_view, packet);
+    }
 
     vk_draw_fences_[frame_index].reset();
 
-    vk_queue_.submit(current_cmd_buffer,
-                     &vk_present_semaphores_[frame_index],
-                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                     &vk_render_semaphores_[next_image.image_index],
-                     &vk_draw_fences_[frame_index]);
+    {
+        PROFILE_ZONE("submit");
+        // Taken before submitting, the GPU cannot start the frame any earlier.
+        gpu_submit_times_[frame_index] = write_gpu_timestamps_ ? profiler::now() : 0;
+        vlk::SubmitBatch batch;
+        batch.add_wait(vk_present_semaphores_[frame_index], VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT)
+             .add_command_buffer(current_cmd_buffer)
+             .add_signal(vk_render_semaphores_[next_image.image_index], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+             .flush(vk_queue_, &vk_draw_fences_[frame_index]);
+    }
+
+    bool should_recreate_swapchain;
+    {
+        PROFILE_ZONE("present");
+        should_recreate_swapchain = vk_queue_.present(vk_swapchain_,
+                                                      vk_render_semaphores_[next_image.image_index],
+                                                      next_image.image_index);
+    }
+    if (should_recreate_swapchain) {
+        recreate_swapchain();
+    }
+
+    ++frame_number_;
+}
+
+// Puts the timestamps of the frame last submitted from this slot on the GPU track. GPU
+// and CPU clocks are lined up by assuming no frame starts on the GPU before it was
+// submitted, the frame that started soonest after its submission sets the offset.
+void Application::read_gpu_timestamps(uint32_t frame_index) {
+    if (gpu_submit_times_[frame_index] == 0) {
+        return;
+    }
+
+    std::array<uint64_t, GPU_TIMESTAMP_COUNT> timestamps;
+    vk_timestamp_pool_->get_results(frame_index * GPU_TIMESTAMP_COUNT, timestamps);
+    std::array<int64_t, GPU_TIMESTAMP_COUNT> gpu_times;
+    for (uint32_t i = 0; i < GPU_TIMESTAMP_COUNT; ++i) {
+        gpu_times[i] = static_cast<int64_t>(static_cast<double>(timestamps[i]) * gpu_timestamp_period_);
+    }
+
+    gpu_clock_offset_ = std::max(gpu_clock_offset_, static_cast<int64_t>(gpu_submit_times_[frame_index]) - gpu_times[0]);
+    auto to_cpu_time = [&](int64_t gpu_time) { return static_cast<uint64_t>(gpu_time + gpu_clock_offset_); };
+    profiler::record_gpu_zone("gpu_uploads", to_cpu_time(gpu_times[0]), to_cpu_time(gpu_times[1]));
+    profiler::record_gpu_zone("gpu_draw", to_cpu_time(gpu_times[1]), to_cpu_time(gpu_times[2]));
+    gpu_submit_times_[frame_index] = 0;
+}
+
+void Application::write_gpu_timestamp(const vlk::CommandBuffer& cmd_buffer, uint32_t timestamp) {
+    if (write_gpu_timestamps_) {
+        const uint32_t frame_index = frame_number_ % NUM_FRAMES_IN_FLIGHT;
+        vkCmdWriteTimestamp2(cmd_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, *vk_timestamp_pool_, frame_index * GPU_TIMESTAMP_COUNT + timestamp);
+    }
+}
 
-    if (vk_queue_.present(vk_swapchain_,
-                          vk_render_semaphores_[next_image.image_index],
-                          next_image.image_index)) {
-        vk_swapchain_ = create_swapchain();
+void Application::upload_buffer(vlk::Buffer& buffer,
+                                std::span<const std::byte> data,
+                                std::optional<vlk::Buffer>& staging_buffer) {
+    if (buffer.is_mapped()) {
+        std::memcpy(buffer.get_mapped_span<std::byte>().data(), data.data(), data.size());
+        buffer.flush();
+        return;
     }
 
-    frame_index = (frame_index + 1) % NUM_FRAMES_IN_FLIGHT;
+    staging_buffer.emplace(vk_memory_allocator_,
+                           buffer.get_size(),
+                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    staging_buffer->copy_memory_to_allocation(data.data(), data.size());
 }
 
 vlk::PhysicalDevice Application::choose_physical_device_and_queue_family() {
@@ -250,12 +565,39 @@ vlk::Device Application::create_device() {
     vlk13_features.dynamicRendering = VK_TRUE;
     vlk13_features.synchronization2 = VK_TRUE;
 
+    // Mesh shaders fetch their data through buffer device addresses.
+    VkPhysicalDeviceVulkan12Features vlk12_features = {};
+    vlk12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vlk12_features.bufferDeviceAddress = VK_TRUE;
+    vlk12_features.pNext = &vlk13_features;
+
     VkPhysicalDeviceVulkan11Features vlk11_features = {};
     vlk11_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
     vlk11_features.shaderDrawParameters = VK_TRUE;
-    vlk11_features.pNext = &vlk13_features;
+    vlk11_features.pNext = &vlk12_features;
+
+    // Mesh shading is optional, devices without it (e.g. lavapipe) keep using the vertex pipeline.
+    auto physical_device_extensions = physical_device.get_extension_properties();
+    VkPhysicalDeviceMeshShaderFeaturesEXT supported_mesh_shader_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT
+    };
+    if (std::ranges::any_of(physical_device_extensions, [](auto& ext) { return strcmp(ext.extensionName, VK_EXT_MESH_SHADER_EXTENSION_NAME) == 0; })) {
+        physical_device.get_features(&supported_mesh_shader_features);
+    }
+    mesh_shading_supported_ = supported_mesh_shader_features.taskShader && supported_mesh_shader_features.meshShader;
+
+    std::vector<const char*> extensions = required_device_extensions;
+    VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+        .taskShader = VK_TRUE,
+        .meshShader = VK_TRUE
+    };
+    if (mesh_shading_supported_) {
+        extensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+        vlk13_features.pNext = &mesh_shader_features;
+    }
 
-    return { physical_device, std::span{ &queue_create_info, 1 }, std::span {required_device_extensions }, &vlk11_features };
+    return { physical_device, std::span{ &queue_create_info, 1 }, std::span{ extensions }, &vlk11_features };
 }
 
 VkSurfaceFormatKHR Application::choose_swapchain_surface_format() {
@@ -278,85 +620,521 @@ vlk::Swapchain Application::create_swapchain() {
     return { vk_device_, vk_surface_, vk_surface_caps_, vk_surface_format_, image_count, vk_frame_extent_ };
 }
 
-vlk::Pipeline Application::create_pipeline() {
-    vlk::ShaderModule shader_module{ vk_device_, "shaders/simple.spv" };
+void Application::toggle_vertex_color() {
+    // Pipelines switch over once the render side gets a packet with the new setting.
+    settings_.use_vertex_color = !settings_.use_vertex_color;
+}
+
+void Application::zoom_camera(float steps) {
+    camera_distance_ = std::clamp(camera_distance_ * std::pow(CAMERA_ZOOM_STEP, -steps), MIN_CAMERA_DISTANCE, MAX_CAMERA_DISTANCE);
+}
+
+void Application::toggle_mesh_shading() {
+    settings_.use_mesh_shading = !settings_.use_mesh_shading;
+    std::println("Mesh shading {}.", !mesh_shading_supported_ ? "is not supported" : settings_.use_mesh_shading ? "on" : "off");
+}
+
+void Application::write_trace() {
+    try {
+        profiler::write_chrome_trace(TRACE_FILENAME);
+        std::println("Trace written to {}.", TRACE_FILENAME);
+    }
+    catch (const std::exception& e) {
+        std::println(std::cerr, "{}", e.what());
+    }
+}
+
+void Application::toggle_culling() {
+    use_culling_ = !use_culling_;
+    std::println("Frustum culling {}.", use_culling_ ? "on" : "off");
+}
+
+VkFormat Application::choose_depth_format() {
+    // Every device supports at least one of these as a depth attachment.
+    for (VkFormat format : { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D16_UNORM }) {
+        auto props = vk_device_.get_physical_device().get_format_properties(format);
+        if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("Failed to find a supported depth format.");
+}
+
+vlk::Image Application::create_depth_image() {
+    return { vk_memory_allocator_,
+             vk_depth_format_,
+             vk_frame_extent_,
+             1,
+             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+             VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT };
+}
+
+void Application::recreate_swapchain() {
+    vk_swapchain_ = create_swapchain();
+    vk_depth_image_ = create_depth_image();
+    vk_depth_image_view_ = { vk_device_, vk_depth_image_, vk_depth_format_, VK_IMAGE_ASPECT_DEPTH_BIT };
+}
+
+Application::MeshPipelines Application::create_mesh_pipelines(assets::VertexFormat vertex_format, bool mesh_shading) {
+    const auto& shader_entry = shader_archive_.get(get_permutation_name(vertex_format, mesh_shading));
+    auto reflection = shader_archive_.get_reflection(shader_entry);
+
+    MeshPipelines pipelines = {
+        .vertex_format = vertex_format,
+        .mesh_shading = mesh_shading,
+        .layout = assets::create_pipeline_layout(vk_device_, reflection),
+        .push_constant_stages = reflection.push_constant_ranges.empty() ? 0 : reflection.push_constant_ranges[0].stage_flags
+    };
+    create_pipeline_variants(pipelines);
+
+    return pipelines;
+}
+
+std::optional<std::array<Application::MeshPipelines, 2>> Application::create_meshlet_pipelines() {
+    if (!mesh_shading_supported_) {
+        return std::nullopt;
+    }
+
+    return std::array{ create_mesh_pipelines(assets::VertexFormat::Float32, true),
+                       create_mesh_pipelines(assets::VertexFormat::Quantized, true) };
+}
+
+void Application::create_pipeline_variants(MeshPipelines& pipelines) {
+    pipelines.color = create_pipeline(pipelines, { vk_depth_format_, VK_COMPARE_OP_LESS, true });
+    pipelines.depth_prepass = create_pipeline(pipelines, { vk_depth_format_, VK_COMPARE_OP_LESS, true }, true);
+    pipelines.depth_equal = create_pipeline(pipelines, { vk_depth_format_, VK_COMPARE_OP_EQUAL, false });
+}
 
-    std::vector<VkPipelineShaderStageCreateInfo> stages(2);
-    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[0].module = shader_module;
-    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-    stages[0].pName = "vert_main";
-    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[1].module = shader_module;
-    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    stages[1].pName = "frag_main";
+vlk::PipelineHandle Application::create_pipeline(const MeshPipelines& pipelines,
+                                                 const vlk::DepthState& depth_state,
+                                                 bool depth_only) {
+    const auto& shader_entry = shader_archive_.get(get_permutation_name(pipelines.vertex_format, pipelines.mesh_shading));
+    const vlk::ShaderModule& shader_module = vk_shader_library_.load(shader_archive_.get_code(shader_entry));
+
+    using ShaderStages = InlineVector<VkPipelineShaderStageCreateInfo, vlk::Pipeline::MAX_STAGES>;
+    auto add_stage = [&](ShaderStages& stages, VkShaderStageFlagBits stage, const char* entry) {
+        stages.push_back({
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = stage,
+            .module = shader_module,
+            .pName = entry
+        });
+    };
+
+    ShaderStages stages;
+    if (pipelines.mesh_shading) {
+        add_stage(stages, VK_SHADER_STAGE_TASK_BIT_EXT, "task_main");
+        add_stage(stages, VK_SHADER_STAGE_MESH_BIT_EXT, "mesh_main");
+    }
+    else {
+        add_stage(stages, VK_SHADER_STAGE_VERTEX_BIT, "vert_main");
+    }
+    if (!depth_only) {
+        add_stage(stages, VK_SHADER_STAGE_FRAGMENT_BIT, "frag_main");
+    }
+
+    vlk::SpecializationConstants specialization;
+    specialization.set(SIMPLE_USE_VERTEX_COLOR, use_vertex_color_);
 
+    if (pipelines.mesh_shading) {
+        return vk_resources_.get_or_create_pipeline(vk_device_,
+                                                    pipelines.layout,
+                                                    stages,
+                                                    vk_surface_format_.format,
+                                                    depth_state,
+                                                    specialization);
+    }
+
+    const bool is_quantized = pipelines.vertex_format == assets::VertexFormat::Quantized;
     const VkVertexInputBindingDescription vertex_binding_description = {
         .binding = 0,
-        .stride = sizeof(Vertex),
+        .stride = is_quantized ? sizeof(assets::QuantizedMeshVertex) : sizeof(Vertex),
         .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
     };
 
-    std::array<VkVertexInputAttributeDescription, 2> vertex_attribute_descriptions = {
-        VkVertexInputAttributeDescription{
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = offsetof(Vertex, position)
-        },
-        VkVertexInputAttributeDescription{
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, color)
+    auto vertex_attribute_descriptions = assets::create_vertex_attributes(shader_archive_.get_reflection(shader_entry),
+                                                                          is_quantized ? std::span{ quantized_vertex_sources } :
+                                                                                         std::span{ vertex_sources });
+
+    return vk_resources_.get_or_create_pipeline(vk_device_,
+                                                pipelines.layout,
+                                                stages,
+                                                vk_surface_format_.format,
+                                                vertex_binding_description,
+                                                vertex_attribute_descriptions,
+                                                depth_state,
+                                                specialization);
+}
+
+void Application::build_scene() {
+    // Mesh-sized spacing makes any mesh fill the same view.
+    const glm::vec3 center = (scene_mesh_.bounds_min + scene_mesh_.bounds_max) * 0.5f;
+    const float radius = std::max(glm::distance(scene_mesh_.bounds_min, scene_mesh_.bounds_max) * 0.5f, 1e-6f);
+    const scene::BoundingSphere bounds = { center, radius };
+    const glm::quat rotation = glm::angleAxis(0.0f, glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+    // All roots go first so the children form one wave of the parallel update.
+    scene_.clear();
+    const float grid_offset = (SCENE_GRID_SIZE - 1) * 0.5f;
+    for (uint32_t z = 0; z < SCENE_GRID_SIZE; ++z) {
+        for (uint32_t x = 0; x < SCENE_GRID_SIZE; ++x) {
+            const glm::vec3 position = glm::vec3{ x - grid_offset, 0.0f, z - grid_offset } * (SCENE_GRID_SPACING * radius);
+            scene_.add_object({ position - center, rotation, glm::vec3{ 1.0f } }, bounds, 0);
+        }
+    }
+
+    // Children orbit their parent as it spins.
+    for (uint32_t parent = 0; parent < SCENE_GRID_SIZE * SCENE_GRID_SIZE; ++parent) {
+        for (uint32_t child = 0; child < SCENE_CHILD_COUNT; ++child) {
+            const float angle = 2.0f * std::numbers::pi_v<float> * child / SCENE_CHILD_COUNT;
+            const glm::vec3 offset = glm::vec3{ std::cos(angle), 0.0f, std::sin(angle) } * (SCENE_CHILD_DISTANCE * radius);
+            scene_.add_object({ center + offset - center * SCENE_CHILD_SCALE, rotation, glm::vec3{ SCENE_CHILD_SCALE } },
+                              bounds,
+                              0,
+                              parent);
+        }
+    }
+
+    scene_radius_ = (grid_offset * SCENE_GRID_SPACING * std::numbers::sqrt2_v<float> + SCENE_CHILD_DISTANCE + 1.0f) * radius;
+    rebuild_culling_hierarchy_ = true;
+}
+
+void Application::animate_scene() {
+    const float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start_time_).count();
+
+    // Children spin the other way, every object at its own phase.
+    const auto parents = scene_.get_parents();
+    auto animate = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t object = begin; object < end; ++object) {
+            const float speed = parents[object] == scene::NO_PARENT ? SCENE_SPIN_SPEED : -2.0f * SCENE_SPIN_SPEED;
+            scene_.set_local_rotation(object, glm::angleAxis(time * speed + object * 0.7f, glm::vec3{ 0.0f, 1.0f, 0.0f }));
+        }
+    };
+
+    jobs::Counter counter;
+    job_system_.parallel_for(counter, static_cast<uint32_t>(parents.size()), INSTANCE_JOB_SIZE, animate);
+    job_system_.wait(counter);
+}
+
+void Application::simulate(FramePacket& packet) {
+    PROFILE_ZONE("simulate");
+
+    {
+        std::lock_guard lock{ streamed_mesh_mutex_ };
+        if (streamed_mesh_) {
+            scene_mesh_ = std::move(*streamed_mesh_);
+            streamed_mesh_.reset();
+            build_scene();
+        }
+    }
+
+    // Frame the scene.
+    int width, height;
+    SDL_GetWindowSizeInPixels(window_.get(), &width, &height);
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+
+    const float distance = camera_distance_ * scene_radius_;
+    const float mesh_radius = std::max(glm::distance(scene_mesh_.bounds_min, scene_mesh_.bounds_max) * 0.5f, 1e-6f);
+    const glm::vec3 camera_position = glm::vec3{ 0.0f, -std::sin(CAMERA_ELEVATION), -std::cos(CAMERA_ELEVATION) } * distance;
+    glm::mat4 projection = glm::perspectiveRH_ZO(CAMERA_FOV_Y,
+                                                 static_cast<float>(width) / static_cast<float>(height),
+                                                 std::max(distance - scene_radius_, mesh_radius * 0.1f),
+                                                 distance + scene_radius_);
+    projection[1][1] = -projection[1][1];
+
+    packet.mesh_generation = scene_mesh_.generation;
+    packet.settings = settings_;
+    packet.view_projection = projection * glm::lookAtRH(camera_position, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, -1.0f, 0.0f });
+    packet.camera_position = camera_position;
+
+    const size_t object_count = scene_.get_object_count();
+    packet.instances.resize(object_count);
+    {
+        PROFILE_ZONE("update_scene");
+        animate_scene();
+        scene_.update(packet.instances, job_system_);
+    }
+
+    // Only objects in view get a LOD and a draw.
+    PROFILE_ZONE("cull_and_queue_draws");
+    if (use_culling_) {
+        if (rebuild_culling_hierarchy_) {
+            culling_hierarchy_.build(scene_);
+            rebuild_culling_hierarchy_ = false;
+        }
+        else {
+            culling_hierarchy_.refit(scene_, job_system_);
+        }
+        culling_stats_ = culling_hierarchy_.cull(scene::make_frustum(packet.view_projection), job_system_, visible_objects_);
+    }
+    else {
+        visible_objects_.resize(object_count);
+        std::iota(visible_objects_.begin(), visible_objects_.end(), 0u);
+        culling_stats_ = {
+            .object_count = static_cast<uint32_t>(object_count),
+            .tested_count = 0,
+            .visible_count = static_cast<uint32_t>(object_count)
+        };
+    }
+
+    const std::span lods{ scene_mesh_.lods };
+    const float projection_scale = assets::get_projection_scale(CAMERA_FOV_Y, static_cast<float>(height));
+    const auto world_radii = scene_.get_world_radii();
+    const auto local_radii = scene_.get_local_radii();
+    const size_t visible_count = visible_objects_.size();
+    const float max_distance = distance + scene_radius_;
+    const auto meshes = scene_.get_meshes();
+    draw_queue_.reset(visible_count);
+    // Every visible object becomes a draw of the coarsest LOD that looks the same from the camera.
+    auto queue_draws = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t object = visible_objects_[i];
+            const glm::vec3 center = {
+                scene_.get_world_centers(0)[object],
+                scene_.get_world_centers(1)[object],
+                scene_.get_world_centers(2)[object]
+            };
+            const float center_distance = glm::distance(center, camera_position);
+            // select_lod works in mesh units, scaled instances see their distance scaled inversely.
+            const float mesh_distance = (center_distance - world_radii[object]) * local_radii[object] / world_radii[object];
+            const scene::DrawKey key = {
+                .pass = 0,
+                .pipeline = 0,
+                .material = 0,
+                .mesh = meshes[object],
+                .lod = assets::select_lod(lods, mesh_distance, projection_scale, LOD_MAX_PIXEL_ERROR),
+                .depth = center_distance / max_distance
+            };
+            draw_queue_.set_draw(i, key, object);
         }
     };
 
-    return { vk_device_,
-             stages,
-             vk_surface_format_.format,
-             vertex_binding_description,
-             vertex_attribute_descriptions };
+    jobs::Counter draw_counter;
+    job_system_.parallel_for(draw_counter, static_cast<uint32_t>(visible_count), INSTANCE_JOB_SIZE, queue_draws);
+    job_system_.wait(draw_counter);
+
+    // Instances sharing a LOD become one instanced draw, front to back within it.
+    draw_queue_.build_batches(job_system_, packet.instance_indices, packet.draws);
+}
+
+void Application::receive_uploads(const vlk::CommandBuffer& cmd_buffer) {
+    auto uploads = asset_streamer_.record_uploads(cmd_buffer, STREAMING_BYTE_BUDGET, frame_number_);
+    for (auto& mesh : uploads.meshes) {
+        if (!mesh.error.empty()) {
+            std::println(std::cerr, "{}", mesh.error);
+            continue;
+        }
+
+        // Replaces a mesh the simulation did not get to yet.
+        if (next_mesh_) {
+            release_mesh(*next_mesh_);
+        }
+        next_mesh_ = MeshGeometry{
+            .generation = ++mesh_generation_,
+            .vertex_buffer = mesh.vertex_buffer,
+            .index_buffer = mesh.index_buffer,
+            .index_type = mesh.index_type,
+            .vertex_format = mesh.vertex_format,
+            .lods = std::move(mesh.lods),
+            .bounds_min = mesh.bounds_min,
+            .bounds_max = mesh.bounds_max,
+            .meshlet_buffer = mesh.meshlet_buffer,
+            .meshlet_count = mesh.meshlet_count,
+            .meshlet_vertices_offset = mesh.meshlet_vertices_offset,
+            .meshlet_triangles_offset = mesh.meshlet_triangles_offset
+        };
+
+        std::lock_guard lock{ streamed_mesh_mutex_ };
+        streamed_mesh_ = next_mesh_;
+    }
+}
+
+void Application::release_mesh(const MeshGeometry& mesh) {
+    // Frames in flight may still be drawing it.
+    auto& vk_buffers = vk_resources_.get_buffers();
+    vk_buffers.release(mesh.vertex_buffer, frame_number_);
+    vk_buffers.release(mesh.index_buffer, frame_number_);
+    vk_buffers.release(mesh.meshlet_buffer, frame_number_);
 }
 
-void Application::record_cmd_buffer(const vlk::CommandBuffer& cmd_buffer, VkImage image, VkImageView image_view) {
+void Application::record_cmd_buffer(const vlk::CommandBuffer& cmd_buffer,
+                                     VkImage image,
+                                     VkImageView image_view,
+                                     const FramePacket& packet) {
     cmd_buffer.begin();
 
-    transition_image_layout(cmd_buffer,
-                            image,
-                            VK_IMAGE_LAYOUT_UNDEFINED,
-                            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                            {},
-                            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
-                            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-                            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    if (write_gpu_timestamps_) {
+        vkCmdResetQueryPool(cmd_buffer, *vk_timestamp_pool_, (frame_number_ % NUM_FRAMES_IN_FLIGHT) * GPU_TIMESTAMP_COUNT, GPU_TIMESTAMP_COUNT);
+    }
+    write_gpu_timestamp(cmd_buffer, 0);
+
+    receive_uploads(cmd_buffer);
+    write_gpu_timestamp(cmd_buffer, 1);
 
-    cmd_buffer.begin_rendering({ 0.0f, 0.0f, 0.0f, 1.0f }, image_view, vk_frame_extent_);
+    // The streamed mesh replaces the drawn one once packets are simulated with it.
+    if (next_mesh_ && packet.mesh_generation == next_mesh_->generation) {
+        release_mesh(mesh_);
+        mesh_ = std::move(*next_mesh_);
+        next_mesh_.reset();
+    }
 
-    vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_);
+    cmd_buffer.transition_image_layout(image,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                       {},
+                                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    cmd_buffer.transition_image_layout(vk_depth_image_,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                       VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                                       VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                                       { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 });
+
+    cmd_buffer.begin_rendering({ 0.0f, 0.0f, 0.0f, 1.0f }, image_view, vk_frame_extent_, vk_depth_image_view_);
 
     VkViewport viewport = { 0.0f, 0.0f, static_cast<float>(vk_frame_extent_.width), static_cast<float>(vk_frame_extent_.height), 0.0f, 1.0f };
     vkCmdSetViewport(cmd_buffer, 0, 1, &viewport);
     VkRect2D scissor = { { 0, 0 }, vk_frame_extent_ };
     vkCmdSetScissor(cmd_buffer, 0, 1, &scissor);
 
-    const VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(cmd_buffer, 0, 1, vk_vertex_buffer_.ptr(), &offset);
-
-    vkCmdBindIndexBuffer(cmd_buffer, vk_index_buffer_, 0, VK_INDEX_TYPE_UINT16);
-
-    vkCmdDrawIndexed(cmd_buffer, indices.size(), 1, 0, 0, 0);
+    // Packets simulated with a mesh that got replaced before it was ever drawn have
+    // nothing to draw.
+    if (packet.mesh_generation == mesh_.generation) {
+        record_draws(cmd_buffer, packet);
+    }
 
     vkCmdEndRendering(cmd_buffer);
 
-    transition_image_layout(cmd_buffer,
-        image,
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
-        {},
-        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-        VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT);
+    cmd_buffer.transition_image_layout(image,
+                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                       {},
+                                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                       VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT);
 
+    write_gpu_timestamp(cmd_buffer, 2);
     cmd_buffer.end();
 }
+
+void Application::record_draws(const vlk::CommandBuffer& cmd_buffer, const FramePacket& packet) {
+    auto& vk_buffers = vk_resources_.get_buffers();
+    auto& vk_pipelines = vk_resources_.get_pipelines();
+
+    const vlk::Buffer& frame_buffer = vk_frame_buffers_[frame_number_ % NUM_FRAMES_IN_FLIGHT];
+    const size_t object_count = packet.instances.size();
+    const VkDeviceSize instances_size = object_count * sizeof(scene::InstanceData);
+    const VkDeviceSize instance_indices_size = packet.instance_indices.size() * sizeof(uint32_t);
+    if (FRAME_INSTANCES_OFFSET + instances_size + instance_indices_size > frame_buffer.get_size()) {
+        throw std::runtime_error{ "Frame packet does not fit the frame buffer." };
+    }
+
+    const auto frame_data = frame_buffer.get_mapped_span<std::byte>();
+    const FrameConstants frame_constants = {
+        .view_projection = packet.view_projection,
+        .camera_position = glm::vec4{ packet.camera_position, 1.0f }
+    };
+    std::memcpy(frame_data.data(), &frame_constants, sizeof(frame_constants));
+    std::memcpy(frame_data.data() + FRAME_INSTANCES_OFFSET, packet.instances.data(), instances_size);
+    std::memcpy(frame_data.data() + FRAME_INSTANCES_OFFSET + instances_size, packet.instance_indices.data(), instance_indices_size);
+    frame_buffer.flush();
+
+    const VkDeviceAddress frame_address = frame_buffer.get_device_address();
+    const VkDeviceAddress instances_address = frame_address + FRAME_INSTANCES_OFFSET;
+    const VkDeviceAddress instance_indices_address = instances_address + instances_size;
+
+    // Quantized positions are decoded by the vertex fetch.
+    glm::vec3 position_offset{ 0.0f };
+    glm::vec3 position_scale{ 1.0f };
+    if (mesh_.vertex_format == assets::VertexFormat::Quantized) {
+        auto quantization_bounds = assets::get_quantization_bounds(mesh_.bounds_min, mesh_.bounds_max);
+        position_offset = quantization_bounds.offset;
+        position_scale = quantization_bounds.scale;
+    }
+
+    if (vk_meshlet_pipelines_ && packet.settings.use_mesh_shading && mesh_.meshlet_count > 0) {
+        const auto& meshlet_pipelines = (*vk_meshlet_pipelines_)[static_cast<size_t>(mesh_.vertex_format)];
+        const VkDeviceAddress meshlet_address = vk_buffers[mesh_.meshlet_buffer].get_device_address();
+        MeshletDrawConstants meshlet_draw = {
+            .meshlets = 0,
+            .meshlet_vertices = meshlet_address + mesh_.meshlet_vertices_offset,
+            .meshlet_triangles = meshlet_address + mesh_.meshlet_triangles_offset,
+            .vertices = vk_buffers[mesh_.vertex_buffer].get_device_address(),
+            .frame = frame_address,
+            .instances = instances_address,
+            .instance_indices = 0,
+            .padding = 0,
+            .position_offset = glm::vec4{ position_offset, 0.0f },
+            .position_scale = glm::vec4{ position_scale, 0.0f },
+            .meshlet_count = 0,
+            .reserved = {}
+        };
+
+        // Task workgroups run along x over the meshlets and along y over the instances,
+        // split into several dispatches once there are too many of them.
+        auto draw_meshlets = [&](vlk::PipelineHandle pipeline) {
+            vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipelines[pipeline]);
+            for (const scene::DrawBatch& batch : packet.draws) {
+                const assets::MeshLod& lod = mesh_.lods[batch.lod];
+                if (lod.meshlet_count == 0) {
+                    continue;
+                }
+
+                meshlet_draw.meshlets = meshlet_address + lod.meshlet_offset * sizeof(assets::Meshlet);
+                meshlet_draw.meshlet_count = lod.meshlet_count;
+                const uint32_t task_group_count = (lod.meshlet_count + MESHLET_TASK_GROUP_SIZE - 1) / MESHLET_TASK_GROUP_SIZE;
+                const uint32_t max_instance_count = std::min(MAX_TASK_GROUP_COUNT, MAX_TASK_GROUP_TOTAL_COUNT / task_group_count);
+                const uint32_t last = batch.first_instance + batch.instance_count;
+                for (uint32_t first = batch.first_instance; first < last; first += max_instance_count) {
+                    meshlet_draw.instance_indices = instance_indices_address + first * sizeof(uint32_t);
+                    vkCmdPushConstants(cmd_buffer, meshlet_pipelines.layout, meshlet_pipelines.push_constant_stages, 0, sizeof(meshlet_draw), &meshlet_draw);
+                    vkCmdDrawMeshTasksEXT(cmd_buffer, task_group_count, std::min(max_instance_count, last - first), 1);
+                }
+            }
+        };
+
+        if (packet.settings.depth_prepass) {
+            draw_meshlets(meshlet_pipelines.depth_prepass);
+        }
+        draw_meshlets(packet.settings.depth_prepass ? meshlet_pipelines.depth_equal : meshlet_pipelines.color);
+    }
+    else {
+        const VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd_buffer, 0, 1, vk_buffers[mesh_.vertex_buffer].ptr(), &offset);
+
+        vkCmdBindIndexBuffer(cmd_buffer, vk_buffers[mesh_.index_buffer], 0, mesh_.index_type);
+
+        const auto& mesh_pipelines = vk_mesh_pipelines_[static_cast<size_t>(mesh_.vertex_format)];
+        DrawConstants draw = {
+            .frame = frame_address,
+            .instances = instances_address,
+            .instance_indices = 0,
+            .padding = 0,
+            .position_offset = glm::vec4{ position_offset, 0.0f },
+            .position_scale = glm::vec4{ position_scale, 0.0f }
+        };
+
+        auto draw_instances = [&](vlk::PipelineHandle pipeline) {
+            vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipelines[pipeline]);
+            for (const scene::DrawBatch& batch : packet.draws) {
+                const assets::MeshLod& lod = mesh_.lods[batch.lod];
+                draw.instance_indices = instance_indices_address + batch.first_instance * sizeof(uint32_t);
+                vkCmdPushConstants(cmd_buffer, mesh_pipelines.layout, mesh_pipelines.push_constant_stages, 0, sizeof(draw), &draw);
+                vkCmdDrawIndexed(cmd_buffer, lod.index_count, batch.instance_count, lod.index_offset, 0, 0);
+            }
+        };
+
+        // The prepass lays down depth without shading, so the main pass only shades visible fragments.
+        if (packet.settings.depth_prepass) {
+            draw_instances(mesh_pipelines.depth_prepass);
+        }
+        draw_instances(packet.settings.depth_prepass ? mesh_pipelines.depth_equal : mesh_pipelines.color);
+    }
+}
@@ -1,45 +1,209 @@
 #pragma once
+#include "assets/asset_streamer.hpp"
+#include "assets/shader_archive.hpp"
+#include "jobs/job_system.hpp"
+#include "scene/culling.hpp"
+#include "scene/draw_queue.hpp"
+#include "scene/scene.hpp"
 #include "utils/non_copyable.hpp"
+#include "utils/triple_buffer.hpp"
 #include "vlk/vlk.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
 
 struct SDL_Window;
 
 class Application final :
     NonCopyable {
 public:
-    Application();
+    explicit Application(const char* mesh_filename = nullptr);
 
     ~Application();
 
+    // Simulates the next frame and, without a render thread, renders it.
     void update();
+
+    void toggle_depth_prepass() noexcept { settings_.depth_prepass = !settings_.depth_prepass; }
+
+    void toggle_vertex_color();
+
+    void toggle_mesh_shading();
+
+    void toggle_culling();
+
+    // Writes the profiler's recorded zones as a Chrome trace.
+    void write_trace();
+
+    // Of the last simulated frame.
+    const scene::CullingStats& get_culling_stats() const noexcept { return culling_stats_; }
+
+    // Positive steps move the camera closer to the scene.
+    void zoom_camera(float steps);
 private:
+    struct RenderSettings {
+        bool use_vertex_color = true;
+        bool use_mesh_shading = true;
+        bool depth_prepass = false;
+    };
+
+    // Geometry of the drawn mesh. generation tells meshes apart as they are replaced.
+    struct MeshGeometry {
+        uint64_t generation = 0;
+        vlk::BufferHandle vertex_buffer; // TODO(Kostu): use one buffer for vertex and index data
+        vlk::BufferHandle index_buffer;
+        VkIndexType index_type = VK_INDEX_TYPE_UINT16;
+        assets::VertexFormat vertex_format = assets::VertexFormat::Float32;
+        std::vector<assets::MeshLod> lods;
+        glm::vec3 bounds_min{ std::numeric_limits<float>::max() };
+        glm::vec3 bounds_max{ std::numeric_limits<float>::lowest() };
+        vlk::BufferHandle meshlet_buffer;
+        uint32_t meshlet_count = 0;
+        VkDeviceSize meshlet_vertices_offset = 0;
+        VkDeviceSize meshlet_triangles_offset = 0;
+    };
+
+    // Everything the render side needs to draw one simulated frame. Packets are reused,
+    // so their vectors keep their capacity from frame to frame.
+    struct FramePacket {
+        uint64_t mesh_generation;
+        RenderSettings settings;
+        glm::mat4 view_projection;
+        glm::vec3 camera_position;
+        std::vector<scene::InstanceData> instances;
+        // Visible instances in draw order, batches draw consecutive runs of them.
+        std::vector<uint32_t> instance_indices;
+        std::vector<scene::DrawBatch> draws;
+    };
+
+    // Pipelines drawing meshes of one vertex format, either from the vertex and index
+    // buffers or from the meshlet tables with task and mesh shaders.
+    struct MeshPipelines {
+        assets::VertexFormat vertex_format;
+        bool mesh_shading;
+        vlk::PipelineLayout layout;
+        VkShaderStageFlags push_constant_stages;
+        vlk::PipelineHandle color;
+        vlk::PipelineHandle depth_prepass;
+        vlk::PipelineHandle depth_equal;
+    };
+
+    void upload_buffer(vlk::Buffer& buffer,
+                       std::span<const std::byte> data,
+                       std::optional<vlk::Buffer>& staging_buffer);
     vlk::PhysicalDevice choose_physical_device_and_queue_family();
     vlk::Device create_device();
     VkSurfaceFormatKHR choose_swapchain_surface_format();
     vlk::Swapchain create_swapchain();
-    vlk::Pipeline create_pipeline();
-    void record_cmd_buffer(const vlk::CommandBuffer& cmd_buffer, VkImage image, VkImageView image_view);
+    VkFormat choose_depth_format();
+    vlk::Image create_depth_image();
+    void recreate_swapchain();
+    MeshPipelines create_mesh_pipelines(assets::VertexFormat vertex_format, bool mesh_shading);
+    std::optional<std::array<MeshPipelines, 2>> create_meshlet_pipelines();
+    void create_pipeline_variants(MeshPipelines& pipelines);
+    vlk::PipelineHandle create_pipeline(const MeshPipelines& pipelines,
+                                        const vlk::DepthState& depth_state,
+                                        bool depth_only = false);
+    void build_scene();
+    void animate_scene();
+    void simulate(FramePacket& packet);
+    void render_main(std::stop_token stop_token);
+    void render(const FramePacket& packet);
+    void receive_uploads(const vlk::CommandBuffer& cmd_buffer);
+    void release_mesh(const MeshGeometry& mesh);
+    void read_gpu_timestamps(uint32_t frame_index);
+    void write_gpu_timestamp(const vlk::CommandBuffer& cmd_buffer, uint32_t timestamp);
+    void record_cmd_buffer(const vlk::CommandBuffer& cmd_buffer,
+                           VkImage image,
+                           VkImageView image_view,
+                           const FramePacket& packet);
+    void record_draws(const vlk::CommandBuffer& cmd_buffer, const FramePacket& packet);
 
+    // Created first so that frame work can fan out from the thread running the application.
+    jobs::JobSystem job_system_;
     std::unique_ptr<SDL_Window, void(*)(SDL_Window*)> window_;
     vlk::Instance vk_instance_;
     vlk::Surface vk_surface_;
     uint32_t vk_queue_family_index_;
+    bool mesh_shading_supported_;
     vlk::Device vk_device_;
     vlk::Queue vk_queue_;
     vlk::CommandPool vk_staging_cmd_pool_;
     vlk::CommandPool vk_cmd_pool_;
     vlk::MemoryAllocator vk_memory_allocator_;
+    vlk::ResourceRegistry vk_resources_;
+    assets::ShaderArchive shader_archive_;
+    vlk::ShaderLibrary vk_shader_library_;
     VkSurfaceCapabilitiesKHR vk_surface_caps_;
     VkSurfaceFormatKHR vk_surface_format_;
+    VkFormat vk_depth_format_;
     VkExtent2D vk_frame_extent_;
     vlk::Swapchain vk_swapchain_;
-    vlk::Pipeline vk_pipeline_;
-    vlk::Buffer vk_vertex_buffer_; // TODO(Kostu): use one buffer for vertex and index data
-    vlk::Buffer vk_index_buffer_;
+    vlk::Image vk_depth_image_;
+    vlk::ImageView vk_depth_image_view_;
+    // Vertex color setting the pipelines were created with.
+    bool use_vertex_color_ = true;
+    // Indexed by assets::VertexFormat.
+    std::array<MeshPipelines, 2> vk_mesh_pipelines_;
+    // Indexed by assets::VertexFormat, empty without VK_EXT_mesh_shader.
+    std::optional<std::array<MeshPipelines, 2>> vk_meshlet_pipelines_;
+    assets::AssetStreamer asset_streamer_;
+
+    // Render side, owned by the render thread when there is one.
+    MeshGeometry mesh_;
+    // Streamed in and waiting for the first packet simulated with it.
+    std::optional<MeshGeometry> next_mesh_;
+    uint64_t mesh_generation_ = 0;
+    // Frame constants, scene instances and LOD-sorted instance indices of each frame in flight.
+    std::vector<vlk::Buffer> vk_frame_buffers_;
     std::vector<vlk::CommandBuffer> vk_cmd_buffers_;
     std::vector<vlk::Fence> vk_draw_fences_;
     std::vector<vlk::Semaphore> vk_present_semaphores_;
     std::vector<vlk::Semaphore> vk_render_semaphores_;
+    uint64_t frame_number_ = 0;
+    // Empty when the queue has no timestamps.
+    std::optional<vlk::QueryPool> vk_timestamp_pool_;
+    double gpu_timestamp_period_ = 0.0;
+    bool write_gpu_timestamps_ = false;
+    // CPU time each frame in flight was submitted at, 0 without timestamps to read back.
+    std::vector<uint64_t> gpu_submit_times_;
+    // Added to GPU times to get CPU times, in nanoseconds.
+    int64_t gpu_clock_offset_ = std::numeric_limits<int64_t>::min();
+
+    // Simulation side, owned by the thread calling update().
+    RenderSettings settings_;
+    MeshGeometry scene_mesh_;
+    // In bounding sphere radii from the scene center.
+    float camera_distance_ = 1.5f;
+    scene::Scene scene_;
+    float scene_radius_ = 0.0f;
+    std::chrono::steady_clock::time_point start_time_ = std::chrono::steady_clock::now();
+    scene::CullingHierarchy culling_hierarchy_;
+    bool use_culling_ = true;
+    // Set when the scene changes and the hierarchy needs more than a refit.
+    bool rebuild_culling_hierarchy_ = true;
+    scene::CullingStats culling_stats_;
+    // Kept around to avoid reallocating it every frame.
+    std::vector<uint32_t> visible_objects_;
+    scene::DrawQueue draw_queue_;
+
+    // Hand-off between the two sides. Meshes go the other way, from uploads back to the simulation.
+    TripleBuffer<FramePacket> packets_;
+    std::atomic<uint64_t> published_packet_count_ = 0;
+    std::atomic<uint64_t> acquired_packet_count_ = 0;
+    std::mutex streamed_mesh_mutex_;
+    std::optional<MeshGeometry> streamed_mesh_;
+    std::mutex render_error_mutex_;
+    std::exception_ptr render_error_;
+    std::jthread render_thread_;
 };
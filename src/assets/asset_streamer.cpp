@@ -0,0 +1,533 @@
+#include "assets/asset_streamer.hpp"
+#include "assets/mesh_file.hpp"
+#include "assets/mesh_optimizer.hpp"
+#include "assets/texture_file.hpp"
+#include "vlk/command_buffer.hpp"
+#include "vlk/device.hpp"
+#include "vlk/memory_allocator.hpp"
+#include "vlk/resource_registry.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Keeps every staged region aligned for any texel block size.
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+// Max-heap order for requests and staged assets.
+constexpr auto by_priority = [](const auto& lhs, const auto& rhs) {
+    return lhs.priority < rhs.priority;
+};
+
+VkDeviceSize align_staging(VkDeviceSize offset) noexcept {
+    return (offset + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+}
+
+// Writes data straight into a host-visible destination, otherwise reserves a
+// range of the staging buffer for it and returns the copy to record.
+VkBufferCopy write_or_stage(const vlk::Buffer& dst_buffer,
+                            std::span<const std::byte> data,
+                            VkDeviceSize& staging_size) {
+    if (dst_buffer.is_mapped()) {
+        std::memcpy(dst_buffer.get_mapped_span<std::byte>().data(), data.data(), data.size());
+        dst_buffer.flush();
+        return { 0, 0, 0 };
+    }
+
+    VkBufferCopy copy = { align_staging(staging_size), 0, data.size() };
+    staging_size = copy.srcOffset + data.size();
+    return copy;
+}
+
+// Index buffers are drawn as is, so every index has to name a vertex of the mesh.
+bool indices_in_range(std::span<const std::byte> index_data, assets::IndexType index_type, uint32_t vertex_count) {
+    const size_t index_size = index_type == assets::IndexType::Uint32 ? sizeof(uint32_t) : sizeof(uint16_t);
+    for (size_t offset = 0; offset + index_size <= index_data.size(); offset += index_size) {
+        uint32_t index = 0;
+        if (index_type == assets::IndexType::Uint32) {
+            std::memcpy(&index, index_data.data() + offset, sizeof(uint32_t));
+        }
+        else {
+            uint16_t index16;
+            std::memcpy(&index16, index_data.data() + offset, sizeof(uint16_t));
+            index = index16;
+        }
+        if (index >= vertex_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reorders a mesh baked without the optimizer. Each LOD range is cache-optimized on its
+// own so the LOD table stays valid. Returns the index type of the rewritten indices and
+// fills remap with the new position of every vertex.
+assets::IndexType optimize_mesh_data(const assets::MeshFile& mesh_file,
+                                     std::vector<std::byte>& vertex_data,
+                                     std::vector<std::byte>& index_data,
+                                     std::vector<uint32_t>& remap) {
+    const auto& header = mesh_file.get_header();
+    auto source_indices = mesh_file.get_index_data();
+    std::vector<uint32_t> indices(header.index_count);
+    if (header.index_type == assets::IndexType::Uint32) {
+        std::memcpy(indices.data(), source_indices.data(), indices.size() * sizeof(uint32_t));
+    }
+    else {
+        for (size_t i = 0; i < indices.size(); ++i) {
+            uint16_t index;
+            std::memcpy(&index, source_indices.data() + i * sizeof(uint16_t), sizeof(index));
+            indices[i] = index;
+        }
+    }
+
+    auto lods = mesh_file.get_lods();
+    if (lods.empty()) {
+        assets::optimize_vertex_cache(indices, header.vertex_count);
+    }
+    for (const auto& lod : lods) {
+        if (uint64_t{ lod.index_offset } + lod.index_count > indices.size()) {
+            throw std::runtime_error{ "LOD index range is out of bounds." };
+        }
+        assets::optimize_vertex_cache(std::span{ indices }.subspan(lod.index_offset, lod.index_count), header.vertex_count);
+    }
+
+    remap.resize(header.vertex_count);
+    uint32_t vertex_count = assets::optimize_vertex_fetch(indices, remap);
+    vertex_data.resize(size_t{ vertex_count } * header.vertex_stride);
+    assets::remap_vertices(vertex_data, mesh_file.get_vertex_data(), header.vertex_stride, remap);
+
+    auto index_type = assets::get_index_type(vertex_count);
+    index_data = assets::pack_indices(indices, index_type);
+    return index_type;
+}
+
+// Packs meshlets, their vertex indices and their triangles into one storage buffer, each
+// table aligned for the task and mesh shaders. Vertex indices go through remap when given.
+std::vector<std::byte> pack_meshlet_data(const assets::MeshFile& mesh_file,
+                                         std::span<const uint32_t> remap,
+                                         VkDeviceSize& vertices_offset,
+                                         VkDeviceSize& triangles_offset) {
+    // Shaders read these through raw addresses, so nothing may point outside the tables.
+    const auto& header = mesh_file.get_header();
+    auto meshlet_vertices = mesh_file.get_meshlet_vertices();
+    for (const auto& meshlet : mesh_file.get_meshlets()) {
+        if (meshlet.vertex_count > assets::MESHLET_MAX_VERTICES ||
+            meshlet.triangle_count > assets::MESHLET_MAX_TRIANGLES ||
+            uint64_t{ meshlet.vertex_offset } + meshlet.vertex_count > meshlet_vertices.size() ||
+            uint64_t{ meshlet.triangle_offset } + meshlet.triangle_count * 3 > mesh_file.get_meshlet_triangles().size()) {
+            throw std::runtime_error{ "Meshlet is out of bounds of the meshlet tables." };
+        }
+        for (uint8_t index : mesh_file.get_meshlet_triangles().subspan(meshlet.triangle_offset, meshlet.triangle_count * 3)) {
+            if (index >= meshlet.vertex_count) {
+                throw std::runtime_error{ "Meshlet triangle references a vertex outside the meshlet." };
+            }
+        }
+    }
+    for (uint32_t vertex : meshlet_vertices) {
+        if (vertex >= header.vertex_count) {
+            throw std::runtime_error{ "Meshlet vertex is out of range." };
+        }
+    }
+
+    auto meshlets = std::as_bytes(mesh_file.get_meshlets());
+    auto meshlet_triangles = std::as_bytes(mesh_file.get_meshlet_triangles());
+
+    vertices_offset = align_staging(meshlets.size());
+    triangles_offset = align_staging(vertices_offset + meshlet_vertices.size_bytes());
+    // Rounded up to whole words, which is how the mesh shader reads triangles.
+    std::vector<std::byte> data((triangles_offset + meshlet_triangles.size() + 3) & ~VkDeviceSize{ 3 });
+    std::memcpy(data.data(), meshlets.data(), meshlets.size());
+    for (size_t i = 0; i < meshlet_vertices.size(); ++i) {
+        uint32_t vertex = remap.empty() ? meshlet_vertices[i] : remap[meshlet_vertices[i]];
+        std::memcpy(data.data() + vertices_offset + i * sizeof(uint32_t), &vertex, sizeof(vertex));
+    }
+    std::memcpy(data.data() + triangles_offset, meshlet_triangles.data(), meshlet_triangles.size());
+
+    return data;
+}
+
+}
+
+namespace assets {
+
+AssetStreamer::AssetStreamer(const vlk::Device& device,
+                             const vlk::MemoryAllocator& allocator,
+                             vlk::ResourceRegistry& registry,
+                             uint32_t worker_count,
+                             uint32_t mesh_load_flags) :
+    device_{ device },
+    allocator_{ allocator },
+    registry_{ registry },
+    mesh_load_flags_{ mesh_load_flags }
+{
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this](std::stop_token stop_token) { worker_main(stop_token); });
+    }
+}
+
+AssetStreamer::~AssetStreamer() {
+    for (auto& worker : workers_) {
+        worker.request_stop();
+    }
+    workers_.clear();
+}
+
+uint64_t AssetStreamer::request_mesh(std::string filename, float priority) {
+    return push_request({ .priority = priority, .type = AssetType::Mesh, .filename = std::move(filename) });
+}
+
+uint64_t AssetStreamer::request_texture(std::string filename, float priority, uint32_t top_mip) {
+    return push_request({ .priority = priority, .type = AssetType::Texture, .filename = std::move(filename), .top_mip = top_mip });
+}
+
+AssetStreamer::Uploads AssetStreamer::record_uploads(const vlk::CommandBuffer& cmd_buffer,
+                                                     VkDeviceSize byte_budget,
+                                                     uint64_t retire_value) {
+    std::vector<StagedAsset> ready;
+    {
+        std::lock_guard lock{ mutex_ };
+        VkDeviceSize budget_used = 0;
+        while (!staged_.empty()) {
+            VkDeviceSize next_size = staged_.front().staging_size;
+            if (!ready.empty() && budget_used + next_size > byte_budget) {
+                break;
+            }
+
+            std::pop_heap(staged_.begin(), staged_.end(), by_priority);
+            ready.push_back(std::move(staged_.back()));
+            staged_.pop_back();
+            budget_used += next_size;
+        }
+    }
+
+    Uploads uploads;
+    bool recorded_buffer_copies = false;
+    auto& buffers = registry_.get_buffers();
+    for (auto& staged : ready) {
+        if (staged.type == AssetType::Mesh) {
+            auto& mesh = uploads.meshes.emplace_back(StreamedMesh{
+                .request_id = staged.request_id,
+                .error = std::move(staged.error)
+            });
+            if (mesh.error.empty()) {
+                record_mesh_upload(cmd_buffer, staged, mesh);
+                recorded_buffer_copies = recorded_buffer_copies || staged.staging_buffer.has_value();
+            }
+        }
+        else {
+            auto& texture = uploads.textures.emplace_back(StreamedTexture{
+                .request_id = staged.request_id,
+                .error = std::move(staged.error)
+            });
+            if (texture.error.empty()) {
+                record_texture_upload(cmd_buffer, staged, texture);
+            }
+        }
+
+        if (staged.staging_buffer) {
+            buffers.release(buffers.create(std::move(*staged.staging_buffer)), retire_value);
+        }
+    }
+
+    if (recorded_buffer_copies) {
+        VkMemoryBarrier2 barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
+            .dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT
+        };
+        if (mesh_load_flags_ & LOAD_MESHLETS) {
+            barrier.dstStageMask |= VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+            barrier.dstAccessMask |= VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+        }
+        const VkDependencyInfo dependency_info = {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &barrier
+        };
+        vkCmdPipelineBarrier2(cmd_buffer, &dependency_info);
+    }
+
+    {
+        std::lock_guard lock{ mutex_ };
+        in_flight_count_ -= ready.size();
+    }
+
+    return uploads;
+}
+
+size_t AssetStreamer::get_pending_count() const {
+    std::lock_guard lock{ mutex_ };
+    return requests_.size() + in_flight_count_;
+}
+
+uint64_t AssetStreamer::push_request(Request request) {
+    uint64_t id;
+    {
+        std::lock_guard lock{ mutex_ };
+        id = next_request_id_++;
+        request.id = id;
+        requests_.push_back(std::move(request));
+        std::push_heap(requests_.begin(), requests_.end(), by_priority);
+    }
+    requests_cv_.notify_one();
+
+    return id;
+}
+
+void AssetStreamer::worker_main(std::stop_token stop_token) {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock lock{ mutex_ };
+            if (!requests_cv_.wait(lock, stop_token, [this] { return !requests_.empty(); })) {
+                return;
+            }
+
+            std::pop_heap(requests_.begin(), requests_.end(), by_priority);
+            request = std::move(requests_.back());
+            requests_.pop_back();
+            ++in_flight_count_;
+        }
+
+        StagedAsset staged = {
+            .request_id = request.id,
+            .priority = request.priority,
+            .type = request.type,
+            .staging_size = 0
+        };
+        try {
+            if (request.type == AssetType::Mesh) {
+                stage_mesh(request, staged);
+            }
+            else {
+                stage_texture(request, staged);
+            }
+        }
+        catch (const std::exception& e) {
+            staged = {
+                .request_id = request.id,
+                .priority = request.priority,
+                .type = request.type,
+                .staging_size = 0,
+                .error = e.what()
+            };
+        }
+
+        std::lock_guard lock{ mutex_ };
+        staged_.push_back(std::move(staged));
+        std::push_heap(staged_.begin(), staged_.end(), by_priority);
+    }
+}
+
+void AssetStreamer::stage_mesh(const Request& request, StagedAsset& staged) const {
+    MeshFile mesh_file{ request.filename.c_str() };
+    const auto& header = mesh_file.get_header();
+    const bool is_quantized = header.vertex_format == VertexFormat::Quantized;
+    if (header.vertex_format != VertexFormat::Float32 && !is_quantized) {
+        throw std::runtime_error(std::format("Unsupported vertex format in: {}", request.filename));
+    }
+    if (header.vertex_stride != (is_quantized ? sizeof(QuantizedMeshVertex) : sizeof(MeshVertex))) {
+        throw std::runtime_error(std::format("Unexpected vertex stride in: {}", request.filename));
+    }
+
+    if (header.index_count * (header.index_type == IndexType::Uint32 ? sizeof(uint32_t) : sizeof(uint16_t)) != header.indices.size) {
+        throw std::runtime_error(std::format("Unexpected index data size in: {}", request.filename));
+    }
+    if (uint64_t{ header.vertex_count } * header.vertex_stride != header.vertices.size) {
+        throw std::runtime_error(std::format("Unexpected vertex data size in: {}", request.filename));
+    }
+    if (!indices_in_range(mesh_file.get_index_data(), header.index_type, header.vertex_count)) {
+        throw std::runtime_error(std::format("Index is out of range in: {}", request.filename));
+    }
+
+    auto lods = mesh_file.get_lods();
+    if (header.lod_count != lods.size()) {
+        throw std::runtime_error(std::format("Unexpected LOD count in: {}", request.filename));
+    }
+    for (const auto& lod : lods) {
+        if (uint64_t{ lod.index_offset } + lod.index_count > header.index_count ||
+            uint64_t{ lod.meshlet_offset } + lod.meshlet_count > header.meshlet_count) {
+            throw std::runtime_error(std::format("LOD is out of bounds in: {}", request.filename));
+        }
+    }
+    staged.lods.assign(lods.begin(), lods.end());
+    if (staged.lods.empty()) {
+        staged.lods.push_back({
+            .index_offset = 0,
+            .index_count = header.index_count,
+            .meshlet_offset = 0,
+            .meshlet_count = header.meshlet_count,
+            .error = 0.0f,
+            .reserved = {}
+        });
+    }
+
+    auto vertex_data = mesh_file.get_vertex_data();
+    auto index_data = mesh_file.get_index_data();
+    IndexType index_type = header.index_type;
+
+    // Mapped data is used as is unless it still has to be optimized into these.
+    std::vector<std::byte> optimized_vertices;
+    std::vector<std::byte> optimized_indices;
+    std::vector<uint32_t> remap;
+    if ((mesh_load_flags_ & OPTIMIZE_MESHES) && !(header.flags & MESH_FLAG_OPTIMIZED)) {
+        index_type = optimize_mesh_data(mesh_file, optimized_vertices, optimized_indices, remap);
+        vertex_data = optimized_vertices;
+        index_data = optimized_indices;
+    }
+
+    std::vector<std::byte> meshlet_data;
+    const bool load_meshlets = (mesh_load_flags_ & LOAD_MESHLETS) && header.meshlet_count > 0;
+    if (load_meshlets) {
+        if (header.meshlet_count != mesh_file.get_meshlets().size()) {
+            throw std::runtime_error(std::format("Unexpected meshlet count in: {}", request.filename));
+        }
+        meshlet_data = pack_meshlet_data(mesh_file, remap, staged.meshlet_vertices_offset, staged.meshlet_triangles_offset);
+    }
+    staged.meshlet_count = load_meshlets ? header.meshlet_count : 0;
+
+    staged.index_type = index_type == IndexType::Uint32 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+    staged.index_count = header.index_count;
+    staged.vertex_format = header.vertex_format;
+    staged.bounds_min = header.bounds_min;
+    staged.bounds_max = header.bounds_max;
+
+    // Mesh shaders fetch vertices through their device address.
+    VkBufferUsageFlags vertex_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (load_meshlets) {
+        vertex_usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
+    staged.vertex_buffer.emplace(allocator_, vertex_data.size(), vertex_usage, vlk::Buffer::UPLOAD_FLAGS);
+    staged.index_buffer.emplace(allocator_,
+                                index_data.size(),
+                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                vlk::Buffer::UPLOAD_FLAGS);
+
+    staged.vertex_copy = write_or_stage(*staged.vertex_buffer, vertex_data, staged.staging_size);
+    staged.index_copy = write_or_stage(*staged.index_buffer, index_data, staged.staging_size);
+    if (load_meshlets) {
+        staged.meshlet_buffer.emplace(allocator_,
+                                      meshlet_data.size(),
+                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                      vlk::Buffer::UPLOAD_FLAGS);
+        staged.meshlet_copy = write_or_stage(*staged.meshlet_buffer, meshlet_data, staged.staging_size);
+    }
+    if (staged.staging_size == 0) {
+        return;
+    }
+
+    staged.staging_buffer.emplace(allocator_,
+                                  staged.staging_size,
+                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  vlk::Buffer::DYNAMIC_FLAGS);
+    auto staging_memory = staged.staging_buffer->get_mapped_span<std::byte>();
+    for (auto [copy, data] : { std::pair{ staged.vertex_copy, vertex_data },
+                               std::pair{ staged.index_copy, index_data },
+                               std::pair{ staged.meshlet_copy, std::span<const std::byte>{ meshlet_data } } }) {
+        if (copy.size > 0) {
+            std::memcpy(staging_memory.data() + copy.srcOffset, data.data(), data.size());
+        }
+    }
+    staged.staging_buffer->flush();
+}
+
+void AssetStreamer::stage_texture(const Request& request, StagedAsset& staged) const {
+    TextureFile texture_file{ request.filename.c_str() };
+    VkFormat format = texture_file.get_format();
+    VkFormatFeatureFlags features = device_.get_physical_device().get_format_properties(format).optimalTilingFeatures;
+    if (!(features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) || !(features & VK_FORMAT_FEATURE_TRANSFER_DST_BIT)) {
+        throw std::runtime_error(std::format("Texture format is not supported by the device - {}", request.filename));
+    }
+
+    staged.top_mip = std::min(request.top_mip, texture_file.get_mip_count() - 1);
+    uint32_t mip_count = texture_file.get_mip_count() - staged.top_mip;
+
+    staged.mip_copies.reserve(mip_count);
+    for (uint32_t i = 0; i < mip_count; ++i) {
+        VkExtent2D mip_extent = texture_file.get_mip_extent(staged.top_mip + i);
+        staged.staging_size = align_staging(staged.staging_size);
+        staged.mip_copies.push_back({
+            .bufferOffset = staged.staging_size,
+            .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 },
+            .imageExtent = { mip_extent.width, mip_extent.height, 1 }
+        });
+        staged.staging_size += texture_file.get_mip_data(staged.top_mip + i).size();
+    }
+
+    staged.image.emplace(allocator_,
+                         format,
+                         texture_file.get_mip_extent(staged.top_mip),
+                         mip_count,
+                         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    staged.image_view.emplace(device_, *staged.image, format, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    staged.staging_buffer.emplace(allocator_,
+                                  staged.staging_size,
+                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  vlk::Buffer::DYNAMIC_FLAGS);
+    auto staging_memory = staged.staging_buffer->get_mapped_span<std::byte>();
+    for (uint32_t i = 0; i < mip_count; ++i) {
+        auto mip_data = texture_file.get_mip_data(staged.top_mip + i);
+        std::memcpy(staging_memory.data() + staged.mip_copies[i].bufferOffset, mip_data.data(), mip_data.size());
+    }
+    staged.staging_buffer->flush();
+}
+
+void AssetStreamer::record_mesh_upload(const vlk::CommandBuffer& cmd_buffer, StagedAsset& staged, StreamedMesh& mesh) {
+    if (staged.vertex_copy.size > 0) {
+        cmd_buffer.copy_buffer(*staged.staging_buffer, *staged.vertex_buffer, staged.vertex_copy);
+    }
+    if (staged.index_copy.size > 0) {
+        cmd_buffer.copy_buffer(*staged.staging_buffer, *staged.index_buffer, staged.index_copy);
+    }
+    if (staged.meshlet_copy.size > 0) {
+        cmd_buffer.copy_buffer(*staged.staging_buffer, *staged.meshlet_buffer, staged.meshlet_copy);
+    }
+
+    auto& buffers = registry_.get_buffers();
+    mesh.vertex_buffer = buffers.create(std::move(*staged.vertex_buffer));
+    mesh.index_buffer = buffers.create(std::move(*staged.index_buffer));
+    mesh.index_type = staged.index_type;
+    mesh.index_count = staged.index_count;
+    mesh.vertex_format = staged.vertex_format;
+    mesh.bounds_min = staged.bounds_min;
+    mesh.bounds_max = staged.bounds_max;
+    mesh.lods = std::move(staged.lods);
+    if (staged.meshlet_buffer) {
+        mesh.meshlet_buffer = buffers.create(std::move(*staged.meshlet_buffer));
+    }
+    mesh.meshlet_count = staged.meshlet_count;
+    mesh.meshlet_vertices_offset = staged.meshlet_vertices_offset;
+    mesh.meshlet_triangles_offset = staged.meshlet_triangles_offset;
+}
+
+void AssetStreamer::record_texture_upload(const vlk::CommandBuffer& cmd_buffer, StagedAsset& staged, StreamedTexture& texture) {
+    cmd_buffer.transition_image_layout(*staged.image,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                       {},
+                                       VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                       VK_PIPELINE_STAGE_2_NONE,
+                                       VK_PIPELINE_STAGE_2_COPY_BIT);
+    cmd_buffer.copy_buffer_to_image(*staged.staging_buffer, *staged.image, staged.mip_copies);
+    cmd_buffer.transition_image_layout(*staged.image,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                       VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                       VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                                       VK_PIPELINE_STAGE_2_COPY_BIT,
+                                       VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+
+    texture.image = registry_.get_images().create(std::move(*staged.image));
+    texture.image_view = registry_.get_image_views().create(std::move(*staged.image_view));
+    texture.top_mip = staged.top_mip;
+}
+
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+#include "utils/non_copyable.hpp"
+#include "vlk/buffer.hpp"
+#include "vlk/image.hpp"
+#include "vlk/image_view.hpp"
+
+#include <volk/volk.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vlk {
+
+class CommandBuffer;
+class Device;
+class MemoryAllocator;
+class ResourceRegistry;
+
+}
+
+namespace assets {
+
+// Loads assets on worker threads and feeds them to the GPU from the render loop.
+//
+// Workers take requests highest priority first, map the file and write it either
+// straight into the destination buffers (when they are host-visible) or into
+// staging memory. The render thread then records the transfers for as many staged
+// assets as the per-frame byte budget allows, again in priority order.
+class AssetStreamer final :
+    NonCopyable {
+public:
+    struct StreamedMesh {
+        uint64_t request_id;
+        vlk::BufferHandle vertex_buffer;
+        vlk::BufferHandle index_buffer;
+        VkIndexType index_type;
+        uint32_t index_count;
+        VertexFormat vertex_format;
+        glm::vec3 bounds_min;
+        glm::vec3 bounds_max;
+        // Index and meshlet ranges of every detail level, LOD 0 first.
+        std::vector<MeshLod> lods;
+        // Meshlet table followed by the meshlet vertex and triangle tables at the given
+        // offsets, only loaded with LOAD_MESHLETS.
+        vlk::BufferHandle meshlet_buffer;
+        uint32_t meshlet_count;
+        VkDeviceSize meshlet_vertices_offset;
+        VkDeviceSize meshlet_triangles_offset;
+        std::string error;
+    };
+
+    struct StreamedTexture {
+        uint64_t request_id;
+        vlk::ImageHandle image;
+        vlk::ImageViewHandle image_view;
+        // Most detailed mip level of the source file that is resident.
+        uint32_t top_mip;
+        std::string error;
+    };
+
+    struct Uploads {
+        std::vector<StreamedMesh> meshes;
+        std::vector<StreamedTexture> textures;
+    };
+
+    // Mesh load flags. OPTIMIZE_MESHES reorders meshes baked without the optimizer for
+    // vertex cache and fetch locality while they are staged. LOAD_MESHLETS uploads the
+    // meshlet tables for the mesh shading path and makes vertex buffers addressable.
+    static constexpr uint32_t OPTIMIZE_MESHES = 1 << 0;
+    static constexpr uint32_t LOAD_MESHLETS = 1 << 1;
+
+    AssetStreamer(const vlk::Device& device,
+                  const vlk::MemoryAllocator& allocator,
+                  vlk::ResourceRegistry& registry,
+                  uint32_t worker_count,
+                  uint32_t mesh_load_flags = 0);
+
+    ~AssetStreamer();
+
+    // Higher priority values are loaded and uploaded first.
+    uint64_t request_mesh(std::string filename, float priority);
+
+    // Loads mips [top_mip, last] of a KTX2/DDS texture, clamped to the smallest one.
+    // The streamer does not track residency: callers start with a coarse top_mip, request
+    // the texture again with a lower one when it covers more of the screen, swap to the
+    // new view once it arrives and release the old image.
+    uint64_t request_texture(std::string filename, float priority, uint32_t top_mip = 0);
+
+    // Records copies for staged assets until byte_budget is spent (at least one asset
+    // is always taken so that large ones cannot starve). Destination resources are moved
+    // into the registry; staging buffers are released into it with retire_value.
+    // Must be called outside of a render pass.
+    Uploads record_uploads(const vlk::CommandBuffer& cmd_buffer,
+                           VkDeviceSize byte_budget,
+                           uint64_t retire_value);
+
+    // Requests not yet handed out by record_uploads().
+    size_t get_pending_count() const;
+private:
+    enum class AssetType {
+        Mesh,
+        Texture
+    };
+
+    struct Request {
+        uint64_t id;
+        float priority;
+        AssetType type;
+        std::string filename;
+        uint32_t top_mip;
+    };
+
+    struct StagedAsset {
+        uint64_t request_id;
+        float priority;
+        AssetType type;
+        std::optional<vlk::Buffer> staging_buffer;
+        VkDeviceSize staging_size;
+        std::string error;
+
+        std::optional<vlk::Buffer> vertex_buffer;
+        std::optional<vlk::Buffer> index_buffer;
+        VkBufferCopy vertex_copy;
+        VkBufferCopy index_copy;
+        VkIndexType index_type;
+        uint32_t index_count;
+        VertexFormat vertex_format;
+        glm::vec3 bounds_min;
+        glm::vec3 bounds_max;
+        std::vector<MeshLod> lods;
+        std::optional<vlk::Buffer> meshlet_buffer;
+        VkBufferCopy meshlet_copy;
+        uint32_t meshlet_count;
+        VkDeviceSize meshlet_vertices_offset;
+        VkDeviceSize meshlet_triangles_offset;
+
+        std::optional<vlk::Image> image;
+        std::optional<vlk::ImageView> image_view;
+        std::vector<VkBufferImageCopy> mip_copies;
+        uint32_t top_mip;
+    };
+
+    uint64_t push_request(Request request);
+
+    void worker_main(std::stop_token stop_token);
+
+    void stage_mesh(const Request& request, StagedAsset& staged) const;
+    void stage_texture(const Request& request, StagedAsset& staged) const;
+
+    void record_mesh_upload(const vlk::CommandBuffer& cmd_buffer, StagedAsset& staged, StreamedMesh& mesh);
+    void record_texture_upload(const vlk::CommandBuffer& cmd_buffer, StagedAsset& staged, StreamedTexture& texture);
+
+    const vlk::Device& device_;
+    const vlk::MemoryAllocator& allocator_;
+    vlk::ResourceRegistry& registry_;
+    const uint32_t mesh_load_flags_;
+    mutable std::mutex mutex_;
+    std::condition_variable_any requests_cv_;
+    std::vector<Request> requests_;
+    std::vector<StagedAsset> staged_;
+    size_t in_flight_count_ = 0;
+    uint64_t next_request_id_ = 1;
+    std::vector<std::jthread> workers_;
+};
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+namespace assets {
+
+// Pixels covered by one mesh unit at distance 1 for a perspective projection.
+inline float get_projection_scale(float fov_y, float viewport_height) noexcept {
+    return viewport_height / (2.0f * std::tan(fov_y * 0.5f));
+}
+
+// Coarsest LOD whose error projects to at most max_pixel_error pixels. distance is measured
+// from the camera to the closest point of the instance bounds, both in mesh units, so scaled
+// instances divide it by their scale first. Cameras inside the bounds always get LOD 0.
+inline uint32_t select_lod(std::span<const MeshLod> lods,
+                           float distance,
+                           float projection_scale,
+                           float max_pixel_error) noexcept {
+    if (distance <= 0.0f) {
+        return 0;
+    }
+
+    const float max_error = max_pixel_error * distance / projection_scale;
+    uint32_t lod = 0;
+    while (lod + 1 < lods.size() && lods[lod + 1].error <= max_error) {
+        ++lod;
+    }
+
+    return lod;
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assets {
+
+// In-memory mesh used while baking, before it is packed into a .vmesh file.
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    // Indices of every LOD back to back, as listed in lods (empty for a single LOD).
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> meshlet_vertices;
+    std::vector<uint8_t> meshlet_triangles;
+};
+
+}
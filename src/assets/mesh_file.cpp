@@ -0,0 +1,32 @@
+#include "assets/mesh_file.hpp"
+
+#include <format>
+#include <stdexcept>
+
+namespace assets {
+
+MeshFile::MeshFile(const char* filename) :
+    file_{ filename }
+{
+    if (file_.get_size() < sizeof(MeshFileHeader)) {
+        throw std::runtime_error(std::format("Not a valid mesh file - {}", filename));
+    }
+
+    const MeshFileHeader& header = get_header();
+    if (header.magic != MESH_FILE_MAGIC) {
+        throw std::runtime_error(std::format("Not a valid mesh file - {}", filename));
+    }
+    if (header.version != MESH_FILE_VERSION) {
+        throw std::runtime_error(std::format("Unsupported mesh file version {} - {}", header.version, filename));
+    }
+
+    for (const MeshBlob& blob : { header.vertices, header.indices, header.lods,
+                                  header.meshlets, header.meshlet_vertices, header.meshlet_triangles }) {
+        if (blob.offset % MESH_BLOB_ALIGNMENT != 0 || blob.offset > file_.get_size() ||
+            blob.size > file_.get_size() - blob.offset) {
+            throw std::runtime_error(std::format("Corrupted mesh file - {}", filename));
+        }
+    }
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace assets {
+
+// Baked mesh mapped straight from disk. Accessors return views into the mapping,
+// nothing is parsed or copied.
+class MeshFile final :
+    NonCopyable {
+public:
+    explicit MeshFile(const char* filename);
+
+    const MeshFileHeader& get_header() const noexcept { return *reinterpret_cast<const MeshFileHeader*>(file_.get_data().data()); }
+
+    std::span<const std::byte> get_vertex_data() const noexcept { return get_blob(get_header().vertices); }
+
+    std::span<const std::byte> get_index_data() const noexcept { return get_blob(get_header().indices); }
+
+    std::span<const MeshLod> get_lods() const noexcept { return get_table<MeshLod>(get_header().lods); }
+
+    std::span<const Meshlet> get_meshlets() const noexcept { return get_table<Meshlet>(get_header().meshlets); }
+
+    std::span<const uint32_t> get_meshlet_vertices() const noexcept { return get_table<uint32_t>(get_header().meshlet_vertices); }
+
+    std::span<const uint8_t> get_meshlet_triangles() const noexcept { return get_table<uint8_t>(get_header().meshlet_triangles); }
+private:
+    std::span<const std::byte> get_blob(const MeshBlob& blob) const noexcept {
+        return file_.get_data().subspan(blob.offset, blob.size);
+    }
+
+    template<typename T>
+    std::span<const T> get_table(const MeshBlob& blob) const noexcept {
+        return { reinterpret_cast<const T*>(file_.get_data().data() + blob.offset), blob.size / sizeof(T) };
+    }
+
+    MappedFile file_;
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// On-disk layout of baked meshes (.vmesh). Everything is little-endian and laid out
+// so that the runtime can map the file and use the blobs in place:
+//
+//   MeshFileHeader | vertices | indices | LOD table | meshlet table | meshlet vertices | meshlet triangles
+//
+// Every blob starts at a MESH_BLOB_ALIGNMENT boundary.
+namespace assets {
+
+inline constexpr uint32_t MESH_FILE_MAGIC = 0x48534D56; // "VMSH"
+inline constexpr uint32_t MESH_FILE_VERSION = 2;
+inline constexpr uint64_t MESH_BLOB_ALIGNMENT = 64;
+
+// MeshFileHeader::flags
+inline constexpr uint32_t MESH_FLAG_OPTIMIZED = 1 << 0; // Indices and vertices already reordered by the baker.
+
+enum class VertexFormat : uint32_t {
+    Float32 = 0,
+    Quantized = 1
+};
+
+enum class IndexType : uint32_t {
+    Uint16 = 0,
+    Uint32 = 1
+};
+
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+    glm::vec3 color;
+};
+static_assert(sizeof(MeshVertex) == 44);
+
+// Positions are snorm16 relative to the mesh bounds (w is padding), normals are
+// octahedral snorm16, UVs half floats and colors unorm8 with alpha 1.
+struct QuantizedMeshVertex {
+    uint16_t position[4];
+    uint16_t normal[2];
+    uint16_t uv[2];
+    uint32_t color;
+};
+static_assert(sizeof(QuantizedMeshVertex) == 20);
+
+struct MeshBlob {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Ranges of the index blob and the meshlet table drawn at a given detail level, LOD 0
+// being the full mesh. LODs share the vertex blob and get coarser with every level.
+struct MeshLod {
+    uint32_t index_offset;
+    uint32_t index_count;
+    uint32_t meshlet_offset;
+    uint32_t meshlet_count;
+    // Largest distance between this LOD's surface and the full mesh, in mesh units.
+    float error;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(MeshLod) == 32);
+
+// Limits of a single meshlet, sized for one mesh shader workgroup.
+inline constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+inline constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// Cluster of the mesh addressing its vertices through the meshlet vertex blob
+// and its triangles as byte triplets in the meshlet triangle blob. Triangle runs
+// start on 4-byte boundaries so shaders can fetch them as words. Every triangle
+// faces away from a viewer at camera when
+// dot(center - camera, cone_axis) >= cone_cutoff * distance(center, camera) + radius.
+struct Meshlet {
+    uint32_t vertex_offset;
+    uint32_t triangle_offset;
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 cone_axis;
+    float cone_cutoff;
+};
+static_assert(sizeof(Meshlet) == 48);
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    VertexFormat vertex_format;
+    IndexType index_type;
+    uint32_t vertex_stride;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t lod_count;
+    uint32_t meshlet_count;
+    uint32_t flags;
+    glm::vec3 bounds_min;
+    glm::vec3 bounds_max;
+    MeshBlob vertices;
+    MeshBlob indices;
+    MeshBlob lods;
+    MeshBlob meshlets;
+    MeshBlob meshlet_vertices;
+    MeshBlob meshlet_triangles;
+};
+static_assert(sizeof(MeshFileHeader) == 160);
+
+constexpr uint64_t align_mesh_blob(uint64_t offset) noexcept {
+    return (offset + MESH_BLOB_ALIGNMENT - 1) & ~(MESH_BLOB_ALIGNMENT - 1);
+}
+
+}
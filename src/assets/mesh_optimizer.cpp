@@ -0,0 +1,308 @@
+#include "assets/mesh_optimizer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Modelled LRU cache size; larger than any real FIFO so the order suits all of them.
+constexpr uint32_t VERTEX_CACHE_SIZE = 32;
+
+// Clusters handed to the overdraw sort are at least this many triangles long,
+// shorter ones would break the cache order too often.
+constexpr size_t MIN_OVERDRAW_CLUSTER_SIZE = 64;
+
+float get_vertex_score(uint32_t cache_position, uint32_t live_triangles) {
+    if (live_triangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cache_position != assets::UNUSED_VERTEX) {
+        // Vertices of the last triangle get a fixed score so it isn't simply repeated.
+        score = cache_position < 3 ?
+            0.75f :
+            std::pow(1.0f - static_cast<float>(cache_position - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+
+    // Favour vertices with few triangles left so they leave the mesh early.
+    return score + 2.0f / std::sqrt(static_cast<float>(live_triangles));
+}
+
+void validate_indices(std::span<const uint32_t> indices, uint32_t vertex_count) {
+    if (indices.size() % 3 != 0) {
+        throw std::runtime_error{ "Index count is not a multiple of 3." };
+    }
+    for (uint32_t index : indices) {
+        if (index >= vertex_count) {
+            throw std::runtime_error(std::format("Index {} is out of range of {} vertices.", index, vertex_count));
+        }
+    }
+}
+
+}
+
+namespace assets {
+
+VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> indices, uint32_t vertex_count, uint32_t cache_size) {
+    validate_indices(indices, vertex_count);
+
+    // A vertex is still cached while fewer than cache_size misses happened since it was loaded.
+    std::vector<uint32_t> load_times(vertex_count, 0);
+    std::vector<bool> referenced(vertex_count, false);
+    uint32_t time = cache_size + 1;
+    uint32_t transformed_count = 0;
+    uint32_t referenced_count = 0;
+    for (uint32_t index : indices) {
+        if (time - load_times[index] > cache_size) {
+            load_times[index] = time++;
+            ++transformed_count;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++referenced_count;
+        }
+    }
+
+    size_t triangle_count = indices.size() / 3;
+    return {
+        .acmr = triangle_count > 0 ? static_cast<float>(transformed_count) / static_cast<float>(triangle_count) : 0.0f,
+        .atvr = referenced_count > 0 ? static_cast<float>(transformed_count) / static_cast<float>(referenced_count) : 0.0f
+    };
+}
+
+void optimize_vertex_cache(std::span<uint32_t> indices, uint32_t vertex_count) {
+    validate_indices(indices, vertex_count);
+    const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Triangles of each vertex, the first live_triangles[v] of them not emitted yet.
+    std::vector<uint32_t> live_triangles(vertex_count, 0);
+    for (uint32_t index : indices) {
+        ++live_triangles[index];
+    }
+    std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+    std::inclusive_scan(live_triangles.begin(), live_triangles.end(), adjacency_offsets.begin() + 1);
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (uint32_t i = 0; i < indices.size(); ++i) {
+            adjacency[cursors[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<uint32_t> cache_positions(vertex_count, UNUSED_VERTEX);
+    std::vector<float> vertex_scores(vertex_count);
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+        vertex_scores[v] = get_vertex_score(UNUSED_VERTEX, live_triangles[v]);
+    }
+    std::vector<float> triangle_scores(triangle_count);
+    for (uint32_t t = 0; t < triangle_count; ++t) {
+        triangle_scores[t] = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+    }
+
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> next_cache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    next_cache.reserve(VERTEX_CACHE_SIZE + 3);
+
+    uint32_t next_unemitted = 0;
+    uint32_t best_triangle = static_cast<uint32_t>(std::distance(triangle_scores.begin(),
+                                                                 std::max_element(triangle_scores.begin(), triangle_scores.end())));
+    while (best_triangle != UNUSED_VERTEX) {
+        emitted[best_triangle] = true;
+        const uint32_t* triangle = &indices[best_triangle * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+
+        next_cache.clear();
+        for (uint32_t i = 0; i < 3; ++i) {
+            uint32_t v = triangle[i];
+            auto begin = adjacency.begin() + adjacency_offsets[v];
+            auto end = begin + live_triangles[v];
+            std::iter_swap(std::find(begin, end, best_triangle), end - 1);
+            --live_triangles[v];
+
+            if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+                next_cache.push_back(v);
+            }
+        }
+        for (uint32_t v : cache) {
+            if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+                next_cache.push_back(v);
+            }
+        }
+
+        // Rescore everything that moved in or out of the cache and pick the best
+        // triangle among those still touching it.
+        for (uint32_t i = 0; i < next_cache.size(); ++i) {
+            uint32_t v = next_cache[i];
+            cache_positions[v] = i < VERTEX_CACHE_SIZE ? i : UNUSED_VERTEX;
+
+            float score = get_vertex_score(cache_positions[v], live_triangles[v]);
+            float delta = score - vertex_scores[v];
+            vertex_scores[v] = score;
+
+            auto begin = adjacency.begin() + adjacency_offsets[v];
+            for (auto it = begin; it != begin + live_triangles[v]; ++it) {
+                triangle_scores[*it] += delta;
+            }
+        }
+        if (next_cache.size() > VERTEX_CACHE_SIZE) {
+            next_cache.resize(VERTEX_CACHE_SIZE);
+        }
+        std::swap(cache, next_cache);
+
+        float best_score = -1.0f;
+        best_triangle = UNUSED_VERTEX;
+        for (uint32_t v : cache) {
+            auto begin = adjacency.begin() + adjacency_offsets[v];
+            for (auto it = begin; it != begin + live_triangles[v]; ++it) {
+                if (triangle_scores[*it] > best_score) {
+                    best_score = triangle_scores[*it];
+                    best_triangle = *it;
+                }
+            }
+        }
+
+        // Nothing left around the cache, continue with the next disconnected part.
+        if (best_triangle == UNUSED_VERTEX) {
+            while (next_unemitted < triangle_count && emitted[next_unemitted]) {
+                ++next_unemitted;
+            }
+            if (next_unemitted < triangle_count) {
+                best_triangle = next_unemitted;
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimize_overdraw(std::span<uint32_t> indices, std::span<const MeshVertex> vertices) {
+    validate_indices(indices, static_cast<uint32_t>(vertices.size()));
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Cut clusters where the cache order restarts (all three vertices missed),
+    // so that reordering them costs next to no extra transforms.
+    std::vector<size_t> cluster_starts = { 0 };
+    std::vector<uint32_t> load_times(vertices.size(), 0);
+    uint32_t time = VERTEX_CACHE_SIZE + 1;
+    for (size_t t = 0; t < triangle_count; ++t) {
+        uint32_t misses = 0;
+        for (size_t i = t * 3; i < t * 3 + 3; ++i) {
+            if (time - load_times[indices[i]] > VERTEX_CACHE_SIZE) {
+                load_times[indices[i]] = time++;
+                ++misses;
+            }
+        }
+        if (misses == 3 && t - cluster_starts.back() >= MIN_OVERDRAW_CLUSTER_SIZE) {
+            cluster_starts.push_back(t);
+        }
+    }
+    cluster_starts.push_back(triangle_count);
+
+    glm::vec3 mesh_centroid{ 0.0f };
+    for (const auto& vertex : vertices) {
+        mesh_centroid += vertex.position;
+    }
+    mesh_centroid /= static_cast<float>(vertices.size());
+
+    // Clusters far out along their own normal occlude the rest from most directions.
+    const size_t cluster_count = cluster_starts.size() - 1;
+    std::vector<float> cluster_scores(cluster_count);
+    for (size_t c = 0; c < cluster_count; ++c) {
+        glm::vec3 centroid{ 0.0f };
+        glm::vec3 normal{ 0.0f };
+        float area = 0.0f;
+        for (size_t t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t) {
+            const glm::vec3& p0 = vertices[indices[t * 3]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+            glm::vec3 triangle_normal = glm::cross(p1 - p0, p2 - p0);
+            float triangle_area = glm::length(triangle_normal);
+
+            centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+            normal += triangle_normal;
+            area += triangle_area;
+        }
+
+        float normal_length = glm::length(normal);
+        cluster_scores[c] = area > 0.0f && normal_length > 0.0f ?
+            glm::dot(centroid / area - mesh_centroid, normal / normal_length) :
+            0.0f;
+    }
+
+    std::vector<size_t> cluster_order(cluster_count);
+    std::iota(cluster_order.begin(), cluster_order.end(), size_t{ 0 });
+    std::stable_sort(cluster_order.begin(), cluster_order.end(), [&](size_t lhs, size_t rhs) {
+        return cluster_scores[lhs] > cluster_scores[rhs];
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (size_t c : cluster_order) {
+        output.insert(output.end(), indices.begin() + cluster_starts[c] * 3, indices.begin() + cluster_starts[c + 1] * 3);
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+uint32_t optimize_vertex_fetch(std::span<uint32_t> indices, std::span<uint32_t> remap) {
+    validate_indices(indices, static_cast<uint32_t>(remap.size()));
+
+    std::fill(remap.begin(), remap.end(), UNUSED_VERTEX);
+    uint32_t vertex_count = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = vertex_count++;
+        }
+        index = remap[index];
+    }
+
+    return vertex_count;
+}
+
+void remap_vertices(std::span<std::byte> dst, std::span<const std::byte> src, size_t stride, std::span<const uint32_t> remap) {
+    if (src.size() != remap.size() * stride) {
+        throw std::runtime_error{ "Vertex data does not match the remap table." };
+    }
+
+    for (size_t i = 0; i < remap.size(); ++i) {
+        if (remap[i] != UNUSED_VERTEX) {
+            std::memcpy(dst.data() + size_t{ remap[i] } * stride, src.data() + i * stride, stride);
+        }
+    }
+}
+
+std::vector<std::byte> pack_indices(std::span<const uint32_t> indices, IndexType index_type) {
+    if (index_type == IndexType::Uint32) {
+        auto bytes = std::as_bytes(indices);
+        return { bytes.begin(), bytes.end() };
+    }
+
+    std::vector<std::byte> packed(indices.size() * sizeof(uint16_t));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] > std::numeric_limits<uint16_t>::max()) {
+            throw std::runtime_error(std::format("Index {} does not fit in 16 bits.", indices[i]));
+        }
+        auto index = static_cast<uint16_t>(indices[i]);
+        std::memcpy(packed.data() + i * sizeof(uint16_t), &index, sizeof(index));
+    }
+
+    return packed;
+}
+
+}
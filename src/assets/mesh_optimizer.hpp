@@ -0,0 +1,49 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// Index and vertex reordering shared by mesh_baker and the load-time fallback of
+// AssetStreamer. Everything works on 32-bit triangle lists; pack_indices narrows
+// the result to whatever get_index_type picked.
+namespace assets {
+
+inline constexpr uint32_t UNUSED_VERTEX = std::numeric_limits<uint32_t>::max();
+
+struct VertexCacheStats {
+    // Average cache miss ratio: transformed vertices per triangle, 0.5 at best.
+    float acmr;
+    // Average transform to vertex ratio: transformed vertices per referenced vertex, 1.0 at best.
+    float atvr;
+};
+
+// Simulates a FIFO post-transform cache of cache_size entries.
+VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> indices, uint32_t vertex_count, uint32_t cache_size = 16);
+
+// Reorders triangles for post-transform cache hits (Forsyth's linear-speed algorithm).
+void optimize_vertex_cache(std::span<uint32_t> indices, uint32_t vertex_count);
+
+// Sorts clusters of cache-optimized triangles so that outward-facing ones are drawn first,
+// which cuts overdraw from most viewpoints while keeping the cache order inside clusters.
+void optimize_overdraw(std::span<uint32_t> indices, std::span<const MeshVertex> vertices);
+
+// Renumbers vertices in the order they are first referenced so fetches walk the vertex
+// buffer linearly. Rewrites indices in place, fills remap (one entry per old vertex,
+// UNUSED_VERTEX for unreferenced ones) and returns the new vertex count.
+uint32_t optimize_vertex_fetch(std::span<uint32_t> indices, std::span<uint32_t> remap);
+
+// Moves every vertex of src to its remapped slot in dst, dropping unused ones.
+void remap_vertices(std::span<std::byte> dst, std::span<const std::byte> src, size_t stride, std::span<const uint32_t> remap);
+
+// 16-bit indices whenever they can address every vertex, keeping 0xFFFF free for primitive restart.
+constexpr IndexType get_index_type(uint32_t vertex_count) noexcept {
+    return vertex_count <= std::numeric_limits<uint16_t>::max() ? IndexType::Uint16 : IndexType::Uint32;
+}
+
+std::vector<std::byte> pack_indices(std::span<const uint32_t> indices, IndexType index_type);
+
+}
@@ -0,0 +1,88 @@
+#include "assets/shader_archive.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace assets {
+
+ShaderArchive::ShaderArchive(const char* filename) :
+    file_{ filename }
+{
+    if (file_.get_size() < sizeof(ShaderArchiveHeader)) {
+        throw std::runtime_error(std::format("Not a valid shader archive - {}", filename));
+    }
+
+    const ShaderArchiveHeader& header = get_header();
+    if (header.magic != SHADER_ARCHIVE_MAGIC) {
+        throw std::runtime_error(std::format("Not a valid shader archive - {}", filename));
+    }
+    if (header.version != SHADER_ARCHIVE_VERSION) {
+        throw std::runtime_error(std::format("Unsupported shader archive version {} - {}", header.version, filename));
+    }
+
+    auto is_valid = [this](const ShaderBlob& blob) {
+        return blob.offset % SHADER_BLOB_ALIGNMENT == 0 && blob.offset <= file_.get_size() &&
+               blob.size <= file_.get_size() - blob.offset;
+    };
+    if (!is_valid(header.entries) || header.entries.size != uint64_t{ header.entry_count } * sizeof(ShaderArchiveEntry)) {
+        throw std::runtime_error(std::format("Corrupted shader archive - {}", filename));
+    }
+    for (const ShaderArchiveEntry& entry : get_entries()) {
+        if (!is_valid(entry.name) || !is_valid(entry.code) || !is_valid(entry.reflection) ||
+            entry.code.size % sizeof(uint32_t) != 0 || entry.reflection.size < sizeof(ShaderReflectionHeader)) {
+            throw std::runtime_error(std::format("Corrupted shader archive - {}", filename));
+        }
+
+        const auto& reflection = *reinterpret_cast<const ShaderReflectionHeader*>(file_.get_data().data() + entry.reflection.offset);
+        uint64_t reflection_size = sizeof(ShaderReflectionHeader) +
+                                   uint64_t{ reflection.vertex_input_count } * sizeof(ReflectedVertexInput) +
+                                   uint64_t{ reflection.push_constant_range_count } * sizeof(ReflectedPushConstantRange) +
+                                   uint64_t{ reflection.descriptor_binding_count } * sizeof(ReflectedDescriptorBinding);
+        if (reflection_size != entry.reflection.size) {
+            throw std::runtime_error(std::format("Corrupted shader archive - {}", filename));
+        }
+    }
+}
+
+const ShaderArchiveEntry* ShaderArchive::find(std::string_view permutation_name) const {
+    uint64_t key = get_shader_key(permutation_name);
+
+    auto entries = get_entries();
+    auto it = std::ranges::lower_bound(entries, key, {}, &ShaderArchiveEntry::key);
+    if (it == entries.end() || it->key != key) {
+        return nullptr;
+    }
+    if (get_name(*it) != permutation_name) {
+        throw std::runtime_error(std::format("Shader permutation {} collides with {} in archive", permutation_name, get_name(*it)));
+    }
+
+    return &*it;
+}
+
+const ShaderArchiveEntry& ShaderArchive::get(std::string_view permutation_name) const {
+    const ShaderArchiveEntry* entry = find(permutation_name);
+    if (!entry) {
+        throw std::runtime_error(std::format("Shader permutation not found in archive: {}", permutation_name));
+    }
+
+    return *entry;
+}
+
+ShaderReflection ShaderArchive::get_reflection(const ShaderArchiveEntry& entry) const noexcept {
+    const std::byte* data = file_.get_data().data() + entry.reflection.offset;
+    const auto& header = *reinterpret_cast<const ShaderReflectionHeader*>(data);
+
+    const auto* vertex_inputs = reinterpret_cast<const ReflectedVertexInput*>(data + sizeof(ShaderReflectionHeader));
+    const auto* push_constant_ranges = reinterpret_cast<const ReflectedPushConstantRange*>(vertex_inputs + header.vertex_input_count);
+    const auto* descriptor_bindings = reinterpret_cast<const ReflectedDescriptorBinding*>(push_constant_ranges + header.push_constant_range_count);
+
+    return {
+        .stage_flags = header.stage_flags,
+        .vertex_inputs = { vertex_inputs, header.vertex_input_count },
+        .push_constant_ranges = { push_constant_ranges, header.push_constant_range_count },
+        .descriptor_bindings = { descriptor_bindings, header.descriptor_binding_count }
+    };
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "assets/shader_archive_format.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace assets {
+
+// Interface of a permutation, reflected from its SPIR-V when the archive was packed.
+struct ShaderReflection {
+    uint32_t stage_flags;
+    std::span<const ReflectedVertexInput> vertex_inputs;
+    std::span<const ReflectedPushConstantRange> push_constant_ranges;
+    std::span<const ReflectedDescriptorBinding> descriptor_bindings;
+};
+
+// Packed shader permutations mapped straight from disk. Lookups are a binary search
+// over the entry table, returned views point into the mapping.
+class ShaderArchive final :
+    NonCopyable {
+public:
+    explicit ShaderArchive(const char* filename);
+
+    // Returns nullptr when the archive has no such permutation. Throws when another
+    // permutation's name hashes to the same key.
+    const ShaderArchiveEntry* find(std::string_view permutation_name) const;
+
+    // Throws when the archive has no such permutation.
+    const ShaderArchiveEntry& get(std::string_view permutation_name) const;
+
+    std::span<const ShaderArchiveEntry> get_entries() const noexcept {
+        const auto& header = get_header();
+        return { reinterpret_cast<const ShaderArchiveEntry*>(file_.get_data().data() + header.entries.offset), header.entry_count };
+    }
+
+    std::string_view get_name(const ShaderArchiveEntry& entry) const noexcept { return get_string(entry.name); }
+
+    std::span<const uint32_t> get_code(const ShaderArchiveEntry& entry) const noexcept {
+        return { reinterpret_cast<const uint32_t*>(file_.get_data().data() + entry.code.offset), entry.code.size / sizeof(uint32_t) };
+    }
+
+    ShaderReflection get_reflection(const ShaderArchiveEntry& entry) const noexcept;
+private:
+    const ShaderArchiveHeader& get_header() const noexcept { return *reinterpret_cast<const ShaderArchiveHeader*>(file_.get_data().data()); }
+
+    std::string_view get_string(const ShaderBlob& blob) const noexcept {
+        return { reinterpret_cast<const char*>(file_.get_data().data() + blob.offset), blob.size };
+    }
+
+    MappedFile file_;
+};
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "utils/hash.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// On-disk layout of packed shader archives (.vsha), produced by shader_packer from
+// every permutation declared in shaders/permutations.cmake:
+//
+//   ShaderArchiveHeader | entry table sorted by key | names, SPIR-V and reflection blobs
+//
+// Every blob starts at a SHADER_BLOB_ALIGNMENT boundary so SPIR-V can be used in place.
+// Reflection blobs are laid out as:
+//
+//   ShaderReflectionHeader | vertex inputs | push constant ranges | descriptor bindings
+namespace assets {
+
+inline constexpr uint32_t SHADER_ARCHIVE_MAGIC = 0x41485356; // "VSHA"
+inline constexpr uint32_t SHADER_ARCHIVE_VERSION = 2;
+inline constexpr uint64_t SHADER_BLOB_ALIGNMENT = 16;
+
+struct ShaderBlob {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Same values as VkShaderStageFlagBits.
+inline constexpr uint32_t SHADER_STAGE_VERTEX = 0x00000001;
+inline constexpr uint32_t SHADER_STAGE_FRAGMENT = 0x00000010;
+inline constexpr uint32_t SHADER_STAGE_COMPUTE = 0x00000020;
+inline constexpr uint32_t SHADER_STAGE_TASK = 0x00000040;
+inline constexpr uint32_t SHADER_STAGE_MESH = 0x00000080;
+
+enum class ShaderComponentType : uint32_t {
+    Uint = 0,
+    Sint = 1,
+    Float = 2
+};
+
+// Same values as VkDescriptorType.
+enum class ShaderDescriptorType : uint32_t {
+    Sampler = 0,
+    CombinedImageSampler = 1,
+    SampledImage = 2,
+    StorageImage = 3,
+    UniformTexelBuffer = 4,
+    StorageTexelBuffer = 5,
+    UniformBuffer = 6,
+    StorageBuffer = 7,
+    InputAttachment = 10,
+    AccelerationStructure = 1000150000
+};
+
+// 32-bit scalar or vector input of the vertex stage.
+struct ReflectedVertexInput {
+    uint32_t location;
+    ShaderComponentType component_type;
+    uint32_t component_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(ReflectedVertexInput) == 16);
+
+struct ReflectedPushConstantRange {
+    uint32_t stage_flags;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t reserved;
+};
+static_assert(sizeof(ReflectedPushConstantRange) == 16);
+
+// A count of 0 marks a runtime-sized array.
+struct ReflectedDescriptorBinding {
+    uint32_t set;
+    uint32_t binding;
+    ShaderDescriptorType type;
+    uint32_t count;
+    uint32_t stage_flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(ReflectedDescriptorBinding) == 24);
+
+struct ShaderReflectionHeader {
+    uint32_t stage_flags;
+    uint32_t vertex_input_count;
+    uint32_t push_constant_range_count;
+    uint32_t descriptor_binding_count;
+};
+static_assert(sizeof(ShaderReflectionHeader) == 16);
+
+struct ShaderArchiveEntry {
+    uint64_t key;
+    ShaderBlob name;
+    ShaderBlob code;
+    ShaderBlob reflection;
+};
+static_assert(sizeof(ShaderArchiveEntry) == 56);
+
+struct ShaderArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    ShaderBlob entries;
+};
+static_assert(sizeof(ShaderArchiveHeader) == 32);
+
+constexpr uint64_t get_shader_key(std::string_view permutation_name) noexcept {
+    return hash_string(permutation_name);
+}
+
+constexpr uint64_t align_shader_blob(uint64_t offset) noexcept {
+    return (offset + SHADER_BLOB_ALIGNMENT - 1) & ~(SHADER_BLOB_ALIGNMENT - 1);
+}
+
+}
@@ -0,0 +1,93 @@
+#include "assets/shader_reflection.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace {
+
+static_assert(assets::SHADER_STAGE_VERTEX == VK_SHADER_STAGE_VERTEX_BIT);
+static_assert(assets::SHADER_STAGE_FRAGMENT == VK_SHADER_STAGE_FRAGMENT_BIT);
+static_assert(assets::SHADER_STAGE_COMPUTE == VK_SHADER_STAGE_COMPUTE_BIT);
+static_assert(assets::SHADER_STAGE_TASK == VK_SHADER_STAGE_TASK_BIT_EXT);
+static_assert(assets::SHADER_STAGE_MESH == VK_SHADER_STAGE_MESH_BIT_EXT);
+static_assert(static_cast<VkDescriptorType>(assets::ShaderDescriptorType::StorageBuffer) == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+static_assert(static_cast<VkDescriptorType>(assets::ShaderDescriptorType::AccelerationStructure) == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR);
+
+VkFormat get_vertex_format(const assets::ReflectedVertexInput& input) {
+    // Indexed by component count - 1, then by component type.
+    static constexpr VkFormat formats[4][3] = {
+        { VK_FORMAT_R32_UINT, VK_FORMAT_R32_SINT, VK_FORMAT_R32_SFLOAT },
+        { VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32_SFLOAT },
+        { VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32_SFLOAT },
+        { VK_FORMAT_R32G32B32A32_UINT, VK_FORMAT_R32G32B32A32_SINT, VK_FORMAT_R32G32B32A32_SFLOAT }
+    };
+
+    auto component_type = static_cast<uint32_t>(input.component_type);
+    if (input.component_count < 1 || input.component_count > 4 || component_type > 2) {
+        throw std::runtime_error(std::format("Unsupported vertex input at location {}", input.location));
+    }
+
+    return formats[input.component_count - 1][component_type];
+}
+
+}
+
+namespace assets {
+
+std::vector<VkVertexInputAttributeDescription> create_vertex_attributes(const ShaderReflection& reflection,
+                                                                        std::span<const VertexAttributeSource> sources) {
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    attributes.reserve(reflection.vertex_inputs.size());
+    for (const auto& input : reflection.vertex_inputs) {
+        auto source = std::ranges::find(sources, input.location, &VertexAttributeSource::location);
+        if (source == sources.end()) {
+            throw std::runtime_error(std::format("No vertex data bound for shader input at location {}", input.location));
+        }
+
+        attributes.push_back({
+            .location = input.location,
+            .binding = source->binding,
+            .format = source->format != VK_FORMAT_UNDEFINED ? source->format : get_vertex_format(input),
+            .offset = source->offset
+        });
+    }
+
+    return attributes;
+}
+
+vlk::PipelineLayout create_pipeline_layout(const vlk::Device& device, const ShaderReflection& reflection) {
+    uint32_t set_count = 0;
+    for (const auto& binding : reflection.descriptor_bindings) {
+        set_count = std::max(set_count, binding.set + 1);
+    }
+
+    // Sets the shader skips still need an empty layout to keep later sets at their index.
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> set_bindings(set_count);
+    for (const auto& binding : reflection.descriptor_bindings) {
+        if (binding.count == 0) {
+            throw std::runtime_error(std::format("Runtime-sized descriptor arrays are not supported (set {}, binding {})",
+                                                 binding.set, binding.binding));
+        }
+
+        set_bindings[binding.set].push_back({
+            .binding = binding.binding,
+            .descriptorType = static_cast<VkDescriptorType>(binding.type),
+            .descriptorCount = binding.count,
+            .stageFlags = binding.stage_flags
+        });
+    }
+
+    std::vector<VkPushConstantRange> push_constant_ranges;
+    for (const auto& range : reflection.push_constant_ranges) {
+        push_constant_ranges.push_back({
+            .stageFlags = range.stage_flags,
+            .offset = range.offset,
+            .size = range.size
+        });
+    }
+
+    return { device, set_bindings, push_constant_ranges };
+}
+
+}
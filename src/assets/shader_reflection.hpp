@@ -0,0 +1,33 @@
+#pragma once
+#include "assets/shader_archive.hpp"
+#include "vlk/pipeline_layout.hpp"
+
+#include <volk/volk.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vlk {
+class Device;
+}
+
+namespace assets {
+
+// Where the data for a vertex shader input lives in the bound vertex buffers.
+// A format overrides the shader's 32-bit one, e.g. for normalized or half data.
+struct VertexAttributeSource {
+    uint32_t location;
+    uint32_t binding;
+    uint32_t offset;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+};
+
+// Formats come from the shader. Sources for locations the shader doesn't read are
+// skipped, a shader input without a source throws.
+std::vector<VkVertexInputAttributeDescription> create_vertex_attributes(const ShaderReflection& reflection,
+                                                                        std::span<const VertexAttributeSource> sources);
+
+vlk::PipelineLayout create_pipeline_layout(const vlk::Device& device, const ShaderReflection& reflection);
+
+}
@@ -0,0 +1,286 @@
+#include "assets/texture_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+    uint32_t dfd_byte_offset;
+    uint32_t dfd_byte_length;
+    uint32_t kvd_byte_offset;
+    uint32_t kvd_byte_length;
+    uint64_t sgd_byte_offset;
+    uint64_t sgd_byte_length;
+};
+static_assert(sizeof(Ktx2Header) == 80);
+
+struct Ktx2Level {
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    uint64_t uncompressed_byte_length;
+};
+
+constexpr uint32_t make_fourcc(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+           (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+constexpr uint32_t DDS_MAGIC = make_fourcc('D', 'D', 'S', ' ');
+constexpr uint32_t DDS_PIXEL_FORMAT_FOURCC = 0x4;
+constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+struct DdsPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourcc;
+    uint32_t rgb_bit_count;
+    uint32_t r_bit_mask;
+    uint32_t g_bit_mask;
+    uint32_t b_bit_mask;
+    uint32_t a_bit_mask;
+};
+
+struct DdsHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitch_or_linear_size;
+    uint32_t depth;
+    uint32_t mip_map_count;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixel_format;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+static_assert(sizeof(DdsHeader) == 128);
+
+struct DdsHeaderDx10 {
+    uint32_t dxgi_format;
+    uint32_t resource_dimension;
+    uint32_t misc_flag;
+    uint32_t array_size;
+    uint32_t misc_flags2;
+};
+
+VkFormat dds_fourcc_to_format(uint32_t fourcc) noexcept {
+    switch (fourcc) {
+    case make_fourcc('D', 'X', 'T', '1'): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case make_fourcc('D', 'X', 'T', '3'): return VK_FORMAT_BC2_UNORM_BLOCK;
+    case make_fourcc('D', 'X', 'T', '5'): return VK_FORMAT_BC3_UNORM_BLOCK;
+    case make_fourcc('A', 'T', 'I', '1'):
+    case make_fourcc('B', 'C', '4', 'U'): return VK_FORMAT_BC4_UNORM_BLOCK;
+    case make_fourcc('B', 'C', '4', 'S'): return VK_FORMAT_BC4_SNORM_BLOCK;
+    case make_fourcc('A', 'T', 'I', '2'):
+    case make_fourcc('B', 'C', '5', 'U'): return VK_FORMAT_BC5_UNORM_BLOCK;
+    case make_fourcc('B', 'C', '5', 'S'): return VK_FORMAT_BC5_SNORM_BLOCK;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+VkFormat dxgi_to_format(uint32_t dxgi_format) noexcept {
+    switch (dxgi_format) {
+    case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+    case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+    case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+    case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+    case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+    case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+    case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+    case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+    case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+    case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+    case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+    case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+    case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+    case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+    case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+    case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+    case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+}
+
+namespace assets {
+
+FormatBlock get_format_block(VkFormat format) noexcept {
+    switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        return { 1, 1, 4 };
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+        return { 4, 4, 8 };
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        return { 4, 4, 16 };
+    default:
+        break;
+    }
+
+    // ASTC formats are enumerated as UNORM/SRGB pairs from 4x4 up to 12x12.
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        constexpr std::array<std::pair<uint32_t, uint32_t>, 14> astc_blocks = { {
+            { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+            { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+        } };
+        auto [width, height] = astc_blocks[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+        return { width, height, 16 };
+    }
+
+    return { 0, 0, 0 };
+}
+
+TextureFile::TextureFile(const char* filename) :
+    file_{ filename }
+{
+    auto data = file_.get_data();
+    if (data.size() >= sizeof(Ktx2Header) && std::memcmp(data.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) == 0) {
+        parse_ktx2(filename);
+    }
+    else if (data.size() >= sizeof(DdsHeader) && *reinterpret_cast<const uint32_t*>(data.data()) == DDS_MAGIC) {
+        parse_dds(filename);
+    }
+    else {
+        throw std::runtime_error(std::format("Not a KTX2 or DDS texture - {}", filename));
+    }
+}
+
+VkExtent2D TextureFile::get_mip_extent(uint32_t mip_level) const noexcept {
+    return { std::max(extent_.width >> mip_level, 1u), std::max(extent_.height >> mip_level, 1u) };
+}
+
+size_t TextureFile::get_mip_size(uint32_t mip_level) const noexcept {
+    FormatBlock block = get_format_block(format_);
+    VkExtent2D mip_extent = get_mip_extent(mip_level);
+    return static_cast<size_t>((mip_extent.width + block.width - 1) / block.width) *
+           ((mip_extent.height + block.height - 1) / block.height) * block.size;
+}
+
+// Rejects empty images and mip chains longer than the extent allows, which would also
+// shift get_mip_extent out of range.
+void TextureFile::set_extent(uint32_t width, uint32_t height, uint32_t level_count, const char* filename) {
+    if (width == 0 || height == 0) {
+        throw std::runtime_error(std::format("Texture has an empty extent - {}", filename));
+    }
+    if (level_count > static_cast<uint32_t>(std::bit_width(std::max(width, height)))) {
+        throw std::runtime_error(std::format("Texture has more mips than its extent allows - {}", filename));
+    }
+    extent_ = { width, height };
+}
+
+void TextureFile::parse_ktx2(const char* filename) {
+    auto data = file_.get_data();
+    const auto& header = *reinterpret_cast<const Ktx2Header*>(data.data());
+    if (header.supercompression_scheme != 0 || header.vk_format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error(std::format("Supercompressed KTX2 textures are not supported - {}", filename));
+    }
+    if (header.pixel_depth > 1 || header.layer_count > 1 || header.face_count != 1) {
+        throw std::runtime_error(std::format("Only 2D KTX2 textures are supported - {}", filename));
+    }
+
+    format_ = static_cast<VkFormat>(header.vk_format);
+    if (get_format_block(format_).size == 0) {
+        throw std::runtime_error(std::format("Unsupported KTX2 format - {}", filename));
+    }
+
+    uint32_t level_count = std::max(header.level_count, 1u);
+    set_extent(header.pixel_width, header.pixel_height, level_count, filename);
+    if (data.size() < sizeof(Ktx2Header) + level_count * sizeof(Ktx2Level)) {
+        throw std::runtime_error(std::format("Corrupted KTX2 texture - {}", filename));
+    }
+
+    const auto* levels = reinterpret_cast<const Ktx2Level*>(data.data() + sizeof(Ktx2Header));
+    mips_.reserve(level_count);
+    for (uint32_t i = 0; i < level_count; ++i) {
+        if (levels[i].byte_offset > data.size() || levels[i].byte_length > data.size() - levels[i].byte_offset ||
+            levels[i].byte_length < get_mip_size(i)) {
+            throw std::runtime_error(std::format("Corrupted KTX2 texture - {}", filename));
+        }
+        mips_.push_back(data.subspan(levels[i].byte_offset, levels[i].byte_length));
+    }
+}
+
+void TextureFile::parse_dds(const char* filename) {
+    auto data = file_.get_data();
+    const auto& header = *reinterpret_cast<const DdsHeader*>(data.data());
+    if (!(header.pixel_format.flags & DDS_PIXEL_FORMAT_FOURCC)) {
+        throw std::runtime_error(std::format("Only block-compressed DDS textures are supported - {}", filename));
+    }
+
+    size_t offset = sizeof(DdsHeader);
+    if (header.pixel_format.fourcc == make_fourcc('D', 'X', '1', '0')) {
+        if (data.size() < offset + sizeof(DdsHeaderDx10)) {
+            throw std::runtime_error(std::format("Corrupted DDS texture - {}", filename));
+        }
+
+        const auto& header_dx10 = *reinterpret_cast<const DdsHeaderDx10*>(data.data() + offset);
+        if (header_dx10.array_size > 1 || (header_dx10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE)) {
+            throw std::runtime_error(std::format("Only 2D DDS textures are supported - {}", filename));
+        }
+        format_ = dxgi_to_format(header_dx10.dxgi_format);
+        offset += sizeof(DdsHeaderDx10);
+    }
+    else {
+        format_ = dds_fourcc_to_format(header.pixel_format.fourcc);
+    }
+
+    if (format_ == VK_FORMAT_UNDEFINED || get_format_block(format_).size == 0) {
+        throw std::runtime_error(std::format("Unsupported DDS pixel format - {}", filename));
+    }
+
+    // Mips are stored back to back from the largest one.
+    uint32_t level_count = std::max(header.mip_map_count, 1u);
+    set_extent(header.width, header.height, level_count, filename);
+    mips_.reserve(level_count);
+    for (uint32_t i = 0; i < level_count; ++i) {
+        size_t mip_size = get_mip_size(i);
+        if (offset + mip_size > data.size()) {
+            throw std::runtime_error(std::format("Corrupted DDS texture - {}", filename));
+        }
+        mips_.push_back(data.subspan(offset, mip_size));
+        offset += mip_size;
+    }
+}
+
+}
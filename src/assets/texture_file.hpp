@@ -0,0 +1,53 @@
+#pragma once
+#include "utils/mapped_file.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <volk/volk.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace assets {
+
+struct FormatBlock {
+    uint32_t width;
+    uint32_t height;
+    uint32_t size;
+};
+
+// Block dimensions and size in bytes of BCn, ASTC and 8-bit RGBA formats.
+// Returns a zero-sized block for anything else.
+FormatBlock get_format_block(VkFormat format) noexcept;
+
+// 2D texture mapped from a KTX2 or DDS file. Mip levels point into the mapping and
+// can be copied to an image as-is. Only single-layer, non-supercompressed files are supported.
+class TextureFile final :
+    NonCopyable {
+public:
+    explicit TextureFile(const char* filename);
+
+    VkFormat get_format() const noexcept { return format_; }
+
+    VkExtent2D get_extent() const noexcept { return extent_; }
+
+    VkExtent2D get_mip_extent(uint32_t mip_level) const noexcept;
+
+    // Bytes a tightly packed mip level takes in format_.
+    size_t get_mip_size(uint32_t mip_level) const noexcept;
+
+    uint32_t get_mip_count() const noexcept { return static_cast<uint32_t>(mips_.size()); }
+
+    std::span<const std::byte> get_mip_data(uint32_t mip_level) const noexcept { return mips_[mip_level]; }
+private:
+    void parse_ktx2(const char* filename);
+    void parse_dds(const char* filename);
+    void set_extent(uint32_t width, uint32_t height, uint32_t level_count, const char* filename);
+
+    MappedFile file_;
+    VkFormat format_ = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent_ = {};
+    std::vector<std::span<const std::byte>> mips_;
+};
+
+}
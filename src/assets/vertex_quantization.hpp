@@ -0,0 +1,81 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/packing.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace assets {
+
+// Maps snorm positions back into the mesh: position = offset + snorm * scale.
+struct QuantizationBounds {
+    glm::vec3 offset;
+    glm::vec3 scale;
+};
+
+inline QuantizationBounds get_quantization_bounds(const glm::vec3& bounds_min, const glm::vec3& bounds_max) noexcept {
+    // Flat meshes would otherwise divide by zero along their flat axis.
+    return {
+        .offset = (bounds_min + bounds_max) * 0.5f,
+        .scale = glm::max((bounds_max - bounds_min) * 0.5f, glm::vec3{ 1e-6f })
+    };
+}
+
+inline glm::vec2 encode_octahedral(glm::vec3 normal) noexcept {
+    float l1_norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1_norm == 0.0f) {
+        return glm::vec2{ 0.0f };
+    }
+
+    normal /= l1_norm;
+    glm::vec2 encoded{ normal.x, normal.y };
+    if (normal.z < 0.0f) {
+        encoded = {
+            (1.0f - std::abs(normal.y)) * (normal.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(normal.x)) * (normal.y >= 0.0f ? 1.0f : -1.0f)
+        };
+    }
+
+    return encoded;
+}
+
+inline glm::vec3 decode_octahedral(const glm::vec2& encoded) noexcept {
+    glm::vec3 normal{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+    float t = std::max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+
+    return glm::normalize(normal);
+}
+
+inline QuantizedMeshVertex quantize_vertex(const MeshVertex& vertex, const QuantizationBounds& bounds) noexcept {
+    glm::vec3 position = (vertex.position - bounds.offset) / bounds.scale;
+    glm::vec2 normal = encode_octahedral(vertex.normal);
+
+    return {
+        .position = { glm::packSnorm1x16(position.x), glm::packSnorm1x16(position.y), glm::packSnorm1x16(position.z), 0 },
+        .normal = { glm::packSnorm1x16(normal.x), glm::packSnorm1x16(normal.y) },
+        .uv = { glm::packHalf1x16(vertex.uv.x), glm::packHalf1x16(vertex.uv.y) },
+        .color = glm::packUnorm4x8(glm::vec4{ vertex.color, 1.0f })
+    };
+}
+
+inline MeshVertex dequantize_vertex(const QuantizedMeshVertex& vertex, const QuantizationBounds& bounds) noexcept {
+    glm::vec3 position{ glm::unpackSnorm1x16(vertex.position[0]),
+                        glm::unpackSnorm1x16(vertex.position[1]),
+                        glm::unpackSnorm1x16(vertex.position[2]) };
+    glm::vec2 normal{ glm::unpackSnorm1x16(vertex.normal[0]), glm::unpackSnorm1x16(vertex.normal[1]) };
+    glm::vec4 color = glm::unpackUnorm4x8(vertex.color);
+
+    return {
+        .position = bounds.offset + position * bounds.scale,
+        .normal = decode_octahedral(normal),
+        .uv = { glm::unpackHalf1x16(vertex.uv[0]), glm::unpackHalf1x16(vertex.uv[1]) },
+        .color = { color.r, color.g, color.b }
+    };
+}
+
+}
@@ -0,0 +1,152 @@
+#include "jobs/job_system.hpp"
+
+#include <limits>
+
+namespace jobs {
+
+namespace {
+
+constexpr uint32_t NO_QUEUE = std::numeric_limits<uint32_t>::max();
+
+// Failed attempts to find a job before a worker goes to sleep.
+constexpr uint32_t IDLE_SPIN_COUNT = 64;
+
+// Queue owned by the calling thread, if it belongs to the system.
+thread_local const JobSystem* current_system = nullptr;
+thread_local uint32_t current_queue = NO_QUEUE;
+
+}
+
+JobSystem::JobSystem(uint32_t worker_count) {
+    queues_.reserve(worker_count + 1);
+    for (uint32_t i = 0; i < worker_count + 1; ++i) {
+        queues_.push_back(std::make_unique<JobQueue>());
+    }
+
+    current_system = this;
+    current_queue = 0;
+
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this, i] { worker_main(i + 1); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    stopping_.store(true);
+    work_epoch_.fetch_add(1);
+    work_epoch_.notify_all();
+    workers_.clear();
+
+    if (current_system == this) {
+        current_system = nullptr;
+        current_queue = NO_QUEUE;
+    }
+}
+
+void JobSystem::run(const Job& job) {
+    job.counter->value_.fetch_add(1, std::memory_order_relaxed);
+
+    const bool owns_queue = current_system == this;
+    if (owns_queue && !queues_[current_queue]->push(job)) {
+        // The queue only fills up with far more jobs than threads, running this one
+        // right away costs no parallelism.
+        execute(job);
+        return;
+    }
+    if (!owns_queue) {
+        std::lock_guard lock{ shared_mutex_ };
+        shared_jobs_.push_back(job);
+        shared_job_count_.fetch_add(1, std::memory_order_release);
+    }
+
+    work_epoch_.fetch_add(1);
+    if (sleeping_count_.load() > 0) {
+        work_epoch_.notify_one();
+    }
+}
+
+void JobSystem::wait(const Counter& counter) {
+    const uint32_t queue_index = current_system == this ? current_queue : NO_QUEUE;
+    while (!counter.is_done()) {
+        if (!run_next_job(queue_index)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::worker_main(uint32_t queue_index) {
+    current_system = this;
+    current_queue = queue_index;
+
+    uint32_t idle_count = 0;
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        // Read before looking for jobs, so jobs added while looking wake us right up.
+        const uint32_t epoch = work_epoch_.load();
+        if (run_next_job(queue_index)) {
+            idle_count = 0;
+            continue;
+        }
+
+        if (++idle_count < IDLE_SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // The destructor may have bumped the epoch after the loop checked stopping_, in
+        // which case nothing would wake this wait.
+        sleeping_count_.fetch_add(1);
+        if (stopping_.load()) {
+            sleeping_count_.fetch_sub(1);
+            break;
+        }
+        work_epoch_.wait(epoch);
+        sleeping_count_.fetch_sub(1);
+        idle_count = 0;
+    }
+}
+
+bool JobSystem::run_next_job(uint32_t queue_index) {
+    if (queue_index != NO_QUEUE) {
+        if (auto job = queues_[queue_index]->pop()) {
+            execute(*job);
+            return true;
+        }
+    }
+
+    if (shared_job_count_.load(std::memory_order_acquire) > 0) {
+        std::unique_lock lock{ shared_mutex_ };
+        if (!shared_jobs_.empty()) {
+            const Job job = shared_jobs_.back();
+            shared_jobs_.pop_back();
+            shared_job_count_.fetch_sub(1, std::memory_order_relaxed);
+            lock.unlock();
+
+            execute(job);
+            return true;
+        }
+    }
+
+    // Start with the next queue over so thieves spread out across victims.
+    const auto queue_count = static_cast<uint32_t>(queues_.size());
+    const uint32_t first_victim = queue_index == NO_QUEUE ? 0 : queue_index + 1;
+    for (uint32_t i = 0; i < queue_count; ++i) {
+        const uint32_t victim = (first_victim + i) % queue_count;
+        if (victim == queue_index) {
+            continue;
+        }
+        if (auto job = queues_[victim]->steal()) {
+            execute(*job);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(const Job& job) {
+    job.function(job.data, job.begin, job.end);
+    job.counter->value_.fetch_sub(1, std::memory_order_release);
+}
+
+}
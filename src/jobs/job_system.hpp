@@ -0,0 +1,92 @@
+#pragma once
+#include "jobs/work_stealing_deque.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jobs {
+
+// Jobs still running of whatever was started with it. Waiting on a counter is how one
+// batch of jobs depends on another.
+class Counter final :
+    NonCopyable {
+public:
+    bool is_done() const noexcept { return value_.load(std::memory_order_acquire) == 0; }
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> value_ = 0;
+};
+
+// A function over the index range [begin, end). data has to stay alive until the job's
+// counter is done. Jobs must not throw.
+struct Job {
+    void (*function)(const void* data, uint32_t begin, uint32_t end);
+    const void* data;
+    uint32_t begin;
+    uint32_t end;
+    Counter* counter;
+};
+
+// Work-stealing scheduler. Every worker and the thread that created the system own a deque
+// they push to and pop from; idle threads steal from the others. Other threads can start
+// jobs too, those go through a shared queue. wait() runs jobs until its counter is done
+// instead of blocking, so the waiting thread always helps.
+class JobSystem final :
+    NonCopyable {
+public:
+    explicit JobSystem(uint32_t worker_count);
+
+    ~JobSystem();
+
+    void run(const Job& job);
+
+    // Runs function(begin, end) over [0, count) in ranges of up to chunk_size indices.
+    // function has to stay alive until counter is done.
+    template<typename F>
+    void parallel_for(Counter& counter, uint32_t count, uint32_t chunk_size, const F& function) {
+        for (uint32_t begin = 0; begin < count; begin += chunk_size) {
+            run({
+                .function = [](const void* data, uint32_t begin, uint32_t end) { (*static_cast<const F*>(data))(begin, end); },
+                .data = &function,
+                .begin = begin,
+                .end = std::min(begin + chunk_size, count),
+                .counter = &counter
+            });
+        }
+    }
+
+    void wait(const Counter& counter);
+
+    // Workers plus the creating thread.
+    uint32_t get_thread_count() const noexcept { return static_cast<uint32_t>(queues_.size()); }
+private:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+
+    using JobQueue = WorkStealingDeque<Job, QUEUE_CAPACITY>;
+
+    void worker_main(uint32_t queue_index);
+
+    bool run_next_job(uint32_t queue_index);
+
+    static void execute(const Job& job);
+
+    // Index 0 belongs to the creating thread.
+    std::vector<std::unique_ptr<JobQueue>> queues_;
+    std::mutex shared_mutex_;
+    std::vector<Job> shared_jobs_;
+    std::atomic<uint32_t> shared_job_count_ = 0;
+    // Bumped whenever jobs are added, idle workers sleep on it.
+    std::atomic<uint32_t> work_epoch_ = 0;
+    std::atomic<uint32_t> sleeping_count_ = 0;
+    std::atomic<bool> stopping_ = false;
+    std::vector<std::jthread> workers_;
+};
+
+}
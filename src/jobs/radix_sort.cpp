@@ -0,0 +1,84 @@
+#include "jobs/radix_sort.hpp"
+
+#include "jobs/job_system.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace jobs {
+
+namespace {
+
+// Items counted and scattered by one job.
+constexpr uint32_t SORT_CHUNK_SIZE = 16384;
+
+constexpr uint32_t DIGIT_COUNT = 8;
+
+uint32_t get_digit(uint64_t key, uint32_t digit) noexcept {
+    return static_cast<uint32_t>(key >> (digit * 8)) & 0xff;
+}
+
+}
+
+void RadixSorter::reserve(size_t item_count) {
+    // sort() swaps items with scratch_, so both end up with either capacity.
+    scratch_.reserve(item_count);
+    histograms_.reserve((item_count + SORT_CHUNK_SIZE - 1) / SORT_CHUNK_SIZE);
+}
+
+void RadixSorter::sort(JobSystem& job_system, std::vector<SortItem>& items) {
+    const auto item_count = static_cast<uint32_t>(items.size());
+    if (item_count < 2) {
+        return;
+    }
+
+    // Bits that differ between any key and the first one, the only digits worth sorting on.
+    uint64_t varying_bits = 0;
+    for (const SortItem& item : items) {
+        varying_bits |= item.key ^ items[0].key;
+    }
+
+    const uint32_t chunk_count = (item_count + SORT_CHUNK_SIZE - 1) / SORT_CHUNK_SIZE;
+    histograms_.resize(chunk_count);
+    scratch_.resize(item_count);
+
+    for (uint32_t digit = 0; digit < DIGIT_COUNT; ++digit) {
+        if (get_digit(varying_bits, digit) == 0) {
+            continue;
+        }
+
+        Counter count_counter;
+        auto count = [&](uint32_t begin, uint32_t end) {
+            Histogram& histogram = histograms_[begin / SORT_CHUNK_SIZE];
+            histogram.fill(0);
+            for (uint32_t i = begin; i < end; ++i) {
+                ++histogram[get_digit(items[i].key, digit)];
+            }
+        };
+        job_system.parallel_for(count_counter, item_count, SORT_CHUNK_SIZE, count);
+        job_system.wait(count_counter);
+
+        // Turns the counts into where each chunk writes each digit: digits in order, and
+        // within a digit chunks in order, which keeps the sort stable.
+        uint32_t offset = 0;
+        for (uint32_t value = 0; value < 256; ++value) {
+            for (Histogram& histogram : histograms_) {
+                offset += std::exchange(histogram[value], offset);
+            }
+        }
+
+        Counter scatter_counter;
+        auto scatter = [&](uint32_t begin, uint32_t end) {
+            Histogram& offsets = histograms_[begin / SORT_CHUNK_SIZE];
+            for (uint32_t i = begin; i < end; ++i) {
+                scratch_[offsets[get_digit(items[i].key, digit)]++] = items[i];
+            }
+        };
+        job_system.parallel_for(scatter_counter, item_count, SORT_CHUNK_SIZE, scatter);
+        job_system.wait(scatter_counter);
+
+        items.swap(scratch_);
+    }
+}
+
+}
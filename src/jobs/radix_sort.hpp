@@ -0,0 +1,37 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jobs {
+
+class JobSystem;
+
+struct SortItem {
+    uint64_t key;
+    uint32_t value;
+};
+
+// Stable least-significant-digit radix sort of 64-bit keys, one byte per pass. Every pass
+// counts digits per chunk of items in parallel, then scatters the chunks in parallel to
+// where the counts of all chunks before them end. Bytes that are the same in every key
+// are skipped, so keys with unused fields sort in fewer passes.
+class RadixSorter final :
+    NonCopyable {
+public:
+    void sort(JobSystem& job_system, std::vector<SortItem>& items);
+
+    // Sorting up to item_count items, whose vector is reserved as well, won't allocate.
+    void reserve(size_t item_count);
+private:
+    using Histogram = std::array<uint32_t, 256>;
+
+    // Kept around to avoid reallocating them every sort.
+    std::vector<SortItem> scratch_;
+    std::vector<Histogram> histograms_;
+};
+
+}
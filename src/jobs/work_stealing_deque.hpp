@@ -0,0 +1,83 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace jobs {
+
+// Fixed-capacity Chase-Lev deque (Lê et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). The owning thread pushes and pops at the bottom, any other thread steals
+// from the top. push() fails instead of growing when the deque is full.
+template<typename T, size_t CAPACITY>
+class WorkStealingDeque final :
+    NonCopyable {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity has to be a power of two");
+public:
+    // Owner only.
+    bool push(const T& item) noexcept {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64_t>(CAPACITY)) {
+            return false;
+        }
+
+        items_[bottom & MASK] = item;
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only.
+    std::optional<T> pop() noexcept {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item = items_[bottom & MASK];
+        if (top == bottom) {
+            // Last item, race the thieves for it.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item.reset();
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    // Any thread.
+    std::optional<T> steal() noexcept {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+
+        T item = items_[top & MASK];
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+
+        return item;
+    }
+private:
+    static constexpr int64_t MASK = static_cast<int64_t>(CAPACITY) - 1;
+
+    // Thieves and the owner work on opposite ends, keep them off one cache line.
+    alignas(64) std::atomic<int64_t> top_ = 0;
+    alignas(64) std::atomic<int64_t> bottom_ = 0;
+    std::array<T, CAPACITY> items_;
+};
+
+}
@@ -22,7 +22,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
     }
 
     try {
-        Application* app = new Application;
+        Application* app = new Application{ argc > 1 ? argv[1] : nullptr };
         *appstate = app;
     }
     catch (const std::exception& e) {
@@ -38,6 +38,26 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
     case SDL_EVENT_QUIT:
     case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
         return SDL_APP_SUCCESS;
+    case SDL_EVENT_KEY_DOWN:
+        if (event->key.key == SDLK_P) {
+            static_cast<Application*>(appstate)->toggle_depth_prepass();
+        }
+        if (event->key.key == SDLK_C) {
+            static_cast<Application*>(appstate)->toggle_vertex_color();
+        }
+        if (event->key.key == SDLK_M) {
+            static_cast<Application*>(appstate)->toggle_mesh_shading();
+        }
+        if (event->key.key == SDLK_F) {
+            static_cast<Application*>(appstate)->toggle_culling();
+        }
+        if (event->key.key == SDLK_T) {
+            static_cast<Application*>(appstate)->write_trace();
+        }
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        static_cast<Application*>(appstate)->zoom_camera(event->wheel.y);
+        break;
     }
 
     return SDL_APP_CONTINUE;
@@ -0,0 +1,268 @@
+#include "scene/culling.hpp"
+
+#include "jobs/job_system.hpp"
+#include "scene/scene.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace scene {
+
+namespace {
+
+// Spheres per leaf, a multiple of every simd::WIDTH.
+constexpr uint32_t LEAF_SIZE = 64;
+
+// Leaves refit or culled by one job.
+constexpr uint32_t LEAF_CHUNK_SIZE = 16;
+
+// Deep enough for any tree built over 32-bit object counts.
+constexpr size_t MAX_TREE_DEPTH = 64;
+
+}
+
+Frustum make_frustum(const glm::mat4& view_projection) noexcept {
+    const auto row = [&](int i) { return glm::vec4{ view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] }; };
+
+    Frustum frustum = { {
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(2),
+        row(3) - row(2)
+    } };
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3{ plane });
+    }
+
+    return frustum;
+}
+
+void CullingHierarchy::build(const Scene& scene) {
+    const auto object_count = static_cast<uint32_t>(scene.get_object_count());
+
+    nodes_.clear();
+    leaf_nodes_.clear();
+    objects_.resize(object_count);
+    std::iota(objects_.begin(), objects_.end(), 0u);
+    for (auto& component : centers_) {
+        component.resize(object_count);
+    }
+    radii_.resize(object_count);
+    visible_slots_.resize(object_count);
+
+    nodes_.push_back({});
+    build_node(0, 0, object_count, scene);
+
+    for (uint32_t leaf : leaf_nodes_) {
+        refit_leaf(scene, nodes_[leaf]);
+    }
+    refit_inner_nodes();
+}
+
+void CullingHierarchy::refit(const Scene& scene, jobs::JobSystem& job_system) {
+    jobs::Counter counter;
+    auto refit_leaves = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            refit_leaf(scene, nodes_[leaf_nodes_[i]]);
+        }
+    };
+    job_system.parallel_for(counter, static_cast<uint32_t>(leaf_nodes_.size()), LEAF_CHUNK_SIZE, refit_leaves);
+    job_system.wait(counter);
+
+    refit_inner_nodes();
+}
+
+CullingStats CullingHierarchy::cull(const Frustum& frustum, jobs::JobSystem& job_system, std::vector<uint32_t>& visible_objects) {
+    CullingStats stats = { .object_count = static_cast<uint32_t>(objects_.size()) };
+    visible_objects.clear();
+    if (objects_.empty()) {
+        return stats;
+    }
+
+    // Walks the tree down to the leaves worth testing, subtrees fully inside the frustum
+    // are taken whole.
+    culled_leaves_.clear();
+    CulledLeaf stack[MAX_TREE_DEPTH];
+    size_t stack_size = 0;
+    stack[stack_size++] = { 0, false };
+    while (stack_size > 0) {
+        CulledLeaf entry = stack[--stack_size];
+        const Node& node = nodes_[entry.node];
+
+        if (!entry.inside) {
+            bool outside = false;
+            entry.inside = true;
+            for (const auto& plane : frustum.planes) {
+                // Box corners farthest along and against the plane normal.
+                const glm::vec3 normal{ plane };
+                glm::vec3 farthest, nearest;
+                for (int axis = 0; axis < 3; ++axis) {
+                    farthest[axis] = normal[axis] >= 0.0f ? node.bounds_max[axis] : node.bounds_min[axis];
+                    nearest[axis] = normal[axis] >= 0.0f ? node.bounds_min[axis] : node.bounds_max[axis];
+                }
+                if (glm::dot(normal, farthest) + plane.w < 0.0f) {
+                    outside = true;
+                    break;
+                }
+                entry.inside &= glm::dot(normal, nearest) + plane.w >= 0.0f;
+            }
+            if (outside) {
+                continue;
+            }
+        }
+
+        if (node.count > 0) {
+            culled_leaves_.push_back(entry);
+        }
+        else {
+            stack[stack_size++] = { node.first + 1, entry.inside };
+            stack[stack_size++] = { node.first, entry.inside };
+        }
+    }
+
+    leaf_visible_counts_.resize(culled_leaves_.size());
+    jobs::Counter counter;
+    auto cull_leaves = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Node& leaf = nodes_[culled_leaves_[i].node];
+            leaf_visible_counts_[i] = culled_leaves_[i].inside ? leaf.count : cull_leaf(frustum, leaf, &visible_slots_[leaf.first]);
+        }
+    };
+    job_system.parallel_for(counter, static_cast<uint32_t>(culled_leaves_.size()), LEAF_CHUNK_SIZE, cull_leaves);
+    job_system.wait(counter);
+
+    for (size_t i = 0; i < culled_leaves_.size(); ++i) {
+        const Node& leaf = nodes_[culled_leaves_[i].node];
+        const uint32_t* visible = culled_leaves_[i].inside ? &objects_[leaf.first] : &visible_slots_[leaf.first];
+        visible_objects.insert(visible_objects.end(), visible, visible + leaf_visible_counts_[i]);
+        if (!culled_leaves_[i].inside) {
+            stats.tested_count += leaf.count;
+        }
+    }
+    stats.visible_count = static_cast<uint32_t>(visible_objects.size());
+
+    return stats;
+}
+
+// Splits objects at the median of the longest axis of their centers until they fit a leaf.
+void CullingHierarchy::build_node(uint32_t node, uint32_t first, uint32_t count, const Scene& scene) {
+    if (count <= LEAF_SIZE) {
+        nodes_[node].first = first;
+        nodes_[node].count = count;
+        leaf_nodes_.push_back(node);
+        return;
+    }
+
+    glm::vec3 centers_min{ std::numeric_limits<float>::max() };
+    glm::vec3 centers_max{ std::numeric_limits<float>::lowest() };
+    for (uint32_t slot = first; slot < first + count; ++slot) {
+        const uint32_t object = objects_[slot];
+        const glm::vec3 center = {
+            scene.get_world_centers(0)[object],
+            scene.get_world_centers(1)[object],
+            scene.get_world_centers(2)[object]
+        };
+        centers_min = glm::min(centers_min, center);
+        centers_max = glm::max(centers_max, center);
+    }
+
+    const glm::vec3 extent = centers_max - centers_min;
+    const size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+    const auto axis_centers = scene.get_world_centers(axis);
+    // Keeps the left half a whole number of leaves so leaves stay full.
+    const uint32_t left_count = (count / 2 + LEAF_SIZE - 1) / LEAF_SIZE * LEAF_SIZE;
+    const auto begin = objects_.begin() + first;
+    std::nth_element(begin, begin + left_count, begin + count, [&](uint32_t a, uint32_t b) { return axis_centers[a] < axis_centers[b]; });
+
+    const auto children = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + 2);
+    nodes_[node].first = children;
+    nodes_[node].count = 0;
+    build_node(children, first, left_count, scene);
+    build_node(children + 1, first + left_count, count - left_count, scene);
+}
+
+void CullingHierarchy::refit_leaf(const Scene& scene, Node& leaf) {
+    const auto radii = scene.get_world_radii();
+    glm::vec3 bounds_min{ std::numeric_limits<float>::max() };
+    glm::vec3 bounds_max{ std::numeric_limits<float>::lowest() };
+    for (uint32_t slot = leaf.first; slot < leaf.first + leaf.count; ++slot) {
+        const uint32_t object = objects_[slot];
+        glm::vec3 center;
+        for (size_t axis = 0; axis < 3; ++axis) {
+            center[axis] = scene.get_world_centers(axis)[object];
+            centers_[axis][slot] = center[axis];
+        }
+        radii_[slot] = radii[object];
+        bounds_min = glm::min(bounds_min, center - radii[object]);
+        bounds_max = glm::max(bounds_max, center + radii[object]);
+    }
+
+    leaf.bounds_min = bounds_min;
+    leaf.bounds_max = bounds_max;
+}
+
+void CullingHierarchy::refit_inner_nodes() {
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        Node& node = nodes_[i];
+        if (node.count == 0) {
+            node.bounds_min = glm::min(nodes_[node.first].bounds_min, nodes_[node.first + 1].bounds_min);
+            node.bounds_max = glm::max(nodes_[node.first].bounds_max, nodes_[node.first + 1].bounds_max);
+        }
+    }
+}
+
+uint32_t CullingHierarchy::cull_leaf(const Frustum& frustum, const Node& leaf, uint32_t* visible) const {
+    const uint32_t last = leaf.first + leaf.count;
+    uint32_t visible_count = 0;
+    uint32_t slot = leaf.first;
+    for (; slot + simd::WIDTH <= last; slot += simd::WIDTH) {
+        visible_count += cull_spheres<simd::FloatBatch>(frustum, slot, visible + visible_count);
+    }
+    for (; slot < last; ++slot) {
+        visible_count += cull_spheres<float>(frustum, slot, visible + visible_count);
+    }
+
+    return visible_count;
+}
+
+template<typename T>
+uint32_t CullingHierarchy::cull_spheres(const Frustum& frustum, uint32_t first, uint32_t* visible) const {
+    constexpr size_t LANES = std::is_same_v<T, float> ? 1 : simd::WIDTH;
+
+    using simd::load;
+    using simd::broadcast;
+    using simd::multiply_add;
+
+    const T x = load<T>(&centers_[0][first]);
+    const T y = load<T>(&centers_[1][first]);
+    const T z = load<T>(&centers_[2][first]);
+    const T radius = load<T>(&radii_[first]);
+
+    // Signed distance of each sphere's surface to the frustum, negative when outside.
+    T distance = broadcast<T>(std::numeric_limits<float>::max());
+    for (const auto& plane : frustum.planes) {
+        const T plane_distance = multiply_add(broadcast<T>(plane.x), x,
+                                              multiply_add(broadcast<T>(plane.y), y, multiply_add(broadcast<T>(plane.z), z, broadcast<T>(plane.w))));
+        distance = simd::min(distance, plane_distance + radius);
+    }
+
+    alignas(32) float distances[LANES];
+    simd::store(distances, distance);
+
+    // Every object is written, only visible ones move the end forward.
+    uint32_t visible_count = 0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        visible[visible_count] = objects_[first + lane];
+        visible_count += distances[lane] >= 0.0f;
+    }
+
+    return visible_count;
+}
+
+}
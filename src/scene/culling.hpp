@@ -0,0 +1,101 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+namespace jobs {
+
+class JobSystem;
+
+}
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace scene {
+
+class Scene;
+
+// Normalized planes facing into the frustum: a point p is inside a plane when
+// dot(plane.xyz, p) + plane.w >= 0.
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+};
+
+// Planes of a view-projection matrix with depth in [0, 1].
+Frustum make_frustum(const glm::mat4& view_projection) noexcept;
+
+struct CullingStats {
+    uint32_t object_count = 0;
+    // Spheres tested one by one, objects in nodes fully inside the frustum are not.
+    uint32_t tested_count = 0;
+    uint32_t visible_count = 0;
+};
+
+// Bounding volume hierarchy over the world bounding spheres of a scene's objects. The
+// tree is built once for a set of objects and refit every frame as they move: nodes keep
+// their objects and only their boxes grow or shrink. Objects moving far from where the
+// tree was built make nodes overlap more, build it again then. Leaves keep the spheres
+// of their objects side by side so they can be tested simd::WIDTH at a time.
+class CullingHierarchy final :
+    NonCopyable {
+public:
+    // Builds the tree over the current world bounds of every object.
+    void build(const Scene& scene);
+
+    // Updates the boxes of every node to the current world bounds, leaves in parallel.
+    void refit(const Scene& scene, jobs::JobSystem& job_system);
+
+    // Replaces visible_objects with the objects whose spheres intersect frustum, tree
+    // order keeps nearby objects together. Leaves are tested in parallel chunks.
+    CullingStats cull(const Frustum& frustum, jobs::JobSystem& job_system, std::vector<uint32_t>& visible_objects);
+
+    size_t get_object_count() const noexcept { return objects_.size(); }
+private:
+    // Leaves own the slots [first, first + count) of the sphere arrays, inner nodes have
+    // count == 0 and their children at first and first + 1. Children always come after
+    // their parent.
+    struct Node {
+        glm::vec3 bounds_min;
+        uint32_t first;
+        glm::vec3 bounds_max;
+        uint32_t count;
+    };
+
+    struct CulledLeaf {
+        uint32_t node;
+        bool inside;
+    };
+
+    void build_node(uint32_t node, uint32_t first, uint32_t count, const Scene& scene);
+
+    void refit_leaf(const Scene& scene, Node& leaf);
+
+    void refit_inner_nodes();
+
+    // Writes the visible objects of a leaf to visible, returns how many there are.
+    uint32_t cull_leaf(const Frustum& frustum, const Node& leaf, uint32_t* visible) const;
+
+    // Tests simd::WIDTH spheres starting at slot first with T = simd::FloatBatch, or just
+    // first with T = float.
+    template<typename T>
+    uint32_t cull_spheres(const Frustum& frustum, uint32_t first, uint32_t* visible) const;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> leaf_nodes_;
+    // Object of every slot, grouped by leaf.
+    std::vector<uint32_t> objects_;
+    std::array<std::vector<float>, 3> centers_;
+    std::vector<float> radii_;
+
+    // Scratch space of cull(), kept around to avoid reallocating it every frame. Leaves
+    // write their visible objects to their own slots of visible_slots_.
+    std::vector<CulledLeaf> culled_leaves_;
+    std::vector<uint32_t> leaf_visible_counts_;
+    std::vector<uint32_t> visible_slots_;
+};
+
+}
@@ -0,0 +1,86 @@
+#include "scene/draw_queue.hpp"
+
+#include <algorithm>
+
+namespace scene {
+
+namespace {
+
+static_assert(DRAW_KEY_PASS_BITS + DRAW_KEY_PIPELINE_BITS + DRAW_KEY_MATERIAL_BITS + DRAW_KEY_MESH_BITS +
+              DRAW_KEY_LOD_BITS + DRAW_KEY_DEPTH_BITS == 64);
+
+constexpr uint32_t DRAW_KEY_DEPTH_SHIFT = 0;
+constexpr uint32_t DRAW_KEY_LOD_SHIFT = DRAW_KEY_DEPTH_SHIFT + DRAW_KEY_DEPTH_BITS;
+constexpr uint32_t DRAW_KEY_MESH_SHIFT = DRAW_KEY_LOD_SHIFT + DRAW_KEY_LOD_BITS;
+constexpr uint32_t DRAW_KEY_MATERIAL_SHIFT = DRAW_KEY_MESH_SHIFT + DRAW_KEY_MESH_BITS;
+constexpr uint32_t DRAW_KEY_PIPELINE_SHIFT = DRAW_KEY_MATERIAL_SHIFT + DRAW_KEY_MATERIAL_BITS;
+constexpr uint32_t DRAW_KEY_PASS_SHIFT = DRAW_KEY_PIPELINE_SHIFT + DRAW_KEY_PIPELINE_BITS;
+
+constexpr uint64_t get_field_mask(uint32_t bits) noexcept {
+    return (uint64_t{ 1 } << bits) - 1;
+}
+
+constexpr uint64_t pack_field(uint32_t value, uint32_t bits, uint32_t shift) noexcept {
+    return (value & get_field_mask(bits)) << shift;
+}
+
+constexpr uint32_t unpack_field(uint64_t key, uint32_t bits, uint32_t shift) noexcept {
+    return static_cast<uint32_t>((key >> shift) & get_field_mask(bits));
+}
+
+}
+
+void DrawQueue::reserve(size_t draw_count) {
+    items_.reserve(draw_count);
+    sorter_.reserve(draw_count);
+}
+
+void DrawQueue::reset(size_t draw_count) {
+    items_.resize(draw_count);
+}
+
+void DrawQueue::set_draw(size_t draw, const DrawKey& key, uint32_t instance) noexcept {
+    items_[draw] = { make_sort_key(key), instance };
+}
+
+void DrawQueue::build_batches(jobs::JobSystem& job_system, std::vector<uint32_t>& instances, std::vector<DrawBatch>& batches) {
+    sorter_.sort(job_system, items_);
+
+    instances.resize(items_.size());
+    batches.clear();
+    uint64_t batch_state = 0;
+    for (size_t i = 0; i < items_.size(); ++i) {
+        instances[i] = items_[i].value;
+
+        const uint64_t state = items_[i].key >> DRAW_KEY_LOD_SHIFT;
+        if (batches.empty() || state != batch_state) {
+            const uint64_t key = items_[i].key;
+            batches.push_back({
+                .pass = unpack_field(key, DRAW_KEY_PASS_BITS, DRAW_KEY_PASS_SHIFT),
+                .pipeline = unpack_field(key, DRAW_KEY_PIPELINE_BITS, DRAW_KEY_PIPELINE_SHIFT),
+                .material = unpack_field(key, DRAW_KEY_MATERIAL_BITS, DRAW_KEY_MATERIAL_SHIFT),
+                .mesh = unpack_field(key, DRAW_KEY_MESH_BITS, DRAW_KEY_MESH_SHIFT),
+                .lod = unpack_field(key, DRAW_KEY_LOD_BITS, DRAW_KEY_LOD_SHIFT),
+                .first_instance = static_cast<uint32_t>(i),
+                .instance_count = 0
+            });
+            batch_state = state;
+        }
+        ++batches.back().instance_count;
+    }
+}
+
+uint64_t DrawQueue::make_sort_key(const DrawKey& key) noexcept {
+    // Written so NaN, e.g. from degenerate distances, ends up at 0 instead of in the cast.
+    const float depth = key.depth > 0.0f ? std::min(key.depth, 1.0f) : 0.0f;
+    const auto quantized_depth = static_cast<uint32_t>(depth * static_cast<float>(get_field_mask(DRAW_KEY_DEPTH_BITS)));
+
+    return pack_field(key.pass, DRAW_KEY_PASS_BITS, DRAW_KEY_PASS_SHIFT) |
+           pack_field(key.pipeline, DRAW_KEY_PIPELINE_BITS, DRAW_KEY_PIPELINE_SHIFT) |
+           pack_field(key.material, DRAW_KEY_MATERIAL_BITS, DRAW_KEY_MATERIAL_SHIFT) |
+           pack_field(key.mesh, DRAW_KEY_MESH_BITS, DRAW_KEY_MESH_SHIFT) |
+           pack_field(key.lod, DRAW_KEY_LOD_BITS, DRAW_KEY_LOD_SHIFT) |
+           pack_field(quantized_depth, DRAW_KEY_DEPTH_BITS, DRAW_KEY_DEPTH_SHIFT);
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "jobs/radix_sort.hpp"
+#include "utils/non_copyable.hpp"
+
+namespace jobs {
+
+class JobSystem;
+
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace scene {
+
+// What a draw needs bound, from the most to the least expensive state to change. depth
+// only orders draws within the same state, 0 is closest to the camera.
+struct DrawKey {
+    uint32_t pass;
+    uint32_t pipeline;
+    uint32_t material;
+    uint32_t mesh;
+    uint32_t lod;
+    float depth;
+};
+
+// Field sizes in bits, from the top of the 64-bit sort key down.
+inline constexpr uint32_t DRAW_KEY_PASS_BITS = 4;
+inline constexpr uint32_t DRAW_KEY_PIPELINE_BITS = 8;
+inline constexpr uint32_t DRAW_KEY_MATERIAL_BITS = 12;
+inline constexpr uint32_t DRAW_KEY_MESH_BITS = 16;
+inline constexpr uint32_t DRAW_KEY_LOD_BITS = 4;
+inline constexpr uint32_t DRAW_KEY_DEPTH_BITS = 20;
+
+// Consecutive draws of one state merged into an instanced draw of the instances
+// [first_instance, first_instance + instance_count) of the sorted instance list.
+struct DrawBatch {
+    uint32_t pass;
+    uint32_t pipeline;
+    uint32_t material;
+    uint32_t mesh;
+    uint32_t lod;
+    uint32_t first_instance;
+    uint32_t instance_count;
+};
+
+// Per-frame render queue: every visible instance gets a sort key, keys are radix sorted
+// and runs of instances sharing everything but depth become one batch. Fields wider than
+// their bits wrap and depth is clamped to [0, 1].
+class DrawQueue final :
+    NonCopyable {
+public:
+    // Frames of up to draw_count draws won't allocate, as long as the instances and
+    // batches passed to build_batches() are reserved as well.
+    void reserve(size_t draw_count);
+
+    // Starts a frame with draw_count draws, set them with set_draw().
+    void reset(size_t draw_count);
+
+    // Draws are independent, so they can be set from several threads.
+    void set_draw(size_t draw, const DrawKey& key, uint32_t instance) noexcept;
+
+    // Sorts the draws and writes their instances in draw order to instances, replacing
+    // batches with the merged draws.
+    void build_batches(jobs::JobSystem& job_system, std::vector<uint32_t>& instances, std::vector<DrawBatch>& batches);
+
+    static uint64_t make_sort_key(const DrawKey& key) noexcept;
+private:
+    std::vector<jobs::SortItem> items_;
+    jobs::RadixSorter sorter_;
+};
+
+}
@@ -0,0 +1,234 @@
+#include "scene/scene.hpp"
+
+#include "jobs/job_system.hpp"
+#include "utils/simd.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace scene {
+
+namespace {
+
+// Objects updated by one job, a multiple of every simd::WIDTH.
+constexpr uint32_t UPDATE_CHUNK_SIZE = 1024;
+
+constexpr float IDENTITY[12] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+};
+
+}
+
+uint32_t Scene::add_object(const Transform& local_transform,
+                           const BoundingSphere& local_bounds,
+                           uint32_t mesh,
+                           uint32_t parent) {
+    const auto object = static_cast<uint32_t>(parents_.size());
+    if (parent != NO_PARENT && parent >= object) {
+        throw std::runtime_error{ "Scene object parent has to be added before its children" };
+    }
+
+    if (wave_starts_.empty() || (parent != NO_PARENT && parent >= wave_starts_.back())) {
+        wave_starts_.push_back(object);
+    }
+    parents_.push_back(parent);
+    meshes_.push_back(mesh);
+    for (auto& component : local_positions_) {
+        component.push_back(0.0f);
+    }
+    for (auto& component : local_rotations_) {
+        component.push_back(0.0f);
+    }
+    for (auto& component : local_scales_) {
+        component.push_back(0.0f);
+    }
+    for (size_t axis = 0; axis < 3; ++axis) {
+        local_centers_[axis].push_back(local_bounds.center[axis]);
+        world_centers_[axis].push_back(local_bounds.center[axis]);
+    }
+    local_radii_.push_back(local_bounds.radius);
+    world_radii_.push_back(local_bounds.radius);
+    for (size_t element = 0; element < 12; ++element) {
+        world_matrices_[element].push_back(IDENTITY[element]);
+    }
+
+    set_local_transform(object, local_transform);
+
+    return object;
+}
+
+void Scene::set_local_transform(uint32_t object, const Transform& local_transform) noexcept {
+    for (size_t axis = 0; axis < 3; ++axis) {
+        local_positions_[axis][object] = local_transform.position[axis];
+        local_scales_[axis][object] = local_transform.scale[axis];
+    }
+    set_local_rotation(object, local_transform.rotation);
+}
+
+void Scene::set_local_rotation(uint32_t object, const glm::quat& rotation) noexcept {
+    local_rotations_[0][object] = rotation.x;
+    local_rotations_[1][object] = rotation.y;
+    local_rotations_[2][object] = rotation.z;
+    local_rotations_[3][object] = rotation.w;
+}
+
+void Scene::clear() noexcept {
+    parents_.clear();
+    wave_starts_.clear();
+    meshes_.clear();
+    local_radii_.clear();
+    world_radii_.clear();
+    for (auto* arrays : { &local_positions_, &local_scales_, &local_centers_, &world_centers_ }) {
+        for (auto& component : *arrays) {
+            component.clear();
+        }
+    }
+    for (auto& component : local_rotations_) {
+        component.clear();
+    }
+    for (auto& element : world_matrices_) {
+        element.clear();
+    }
+}
+
+void Scene::update(std::span<InstanceData> instances) {
+    if (instances.size() < parents_.size()) {
+        throw std::runtime_error{ "Instance buffer is too small for the scene" };
+    }
+
+    update_range(0, parents_.size(), instances);
+}
+
+void Scene::update(std::span<InstanceData> instances, jobs::JobSystem& job_system) {
+    if (instances.size() < parents_.size()) {
+        throw std::runtime_error{ "Instance buffer is too small for the scene" };
+    }
+
+    for (size_t wave = 0; wave < wave_starts_.size(); ++wave) {
+        const uint32_t first = wave_starts_[wave];
+        const uint32_t last = wave + 1 < wave_starts_.size() ? wave_starts_[wave + 1] : static_cast<uint32_t>(parents_.size());
+
+        jobs::Counter counter;
+        auto update_chunk = [&](uint32_t begin, uint32_t end) { update_range(first + begin, first + end, instances); };
+        job_system.parallel_for(counter, last - first, UPDATE_CHUNK_SIZE, update_chunk);
+        job_system.wait(counter);
+    }
+}
+
+void Scene::update_range(size_t first, size_t last, std::span<InstanceData> instances) {
+    size_t object = first;
+    while (object + simd::WIDTH <= last) {
+        // A parent inside the batch would be read before it is written, so such batches
+        // fall back to one object at a time, which resolves them in order.
+        bool independent = true;
+        for (size_t lane = 0; lane < simd::WIDTH; ++lane) {
+            const uint32_t parent = parents_[object + lane];
+            independent &= parent == NO_PARENT || parent < object;
+        }
+
+        if (independent) {
+            update_objects<simd::FloatBatch>(object, instances);
+        }
+        else {
+            for (size_t lane = 0; lane < simd::WIDTH; ++lane) {
+                update_objects<float>(object + lane, instances);
+            }
+        }
+        object += simd::WIDTH;
+    }
+
+    for (; object < last; ++object) {
+        update_objects<float>(object, instances);
+    }
+}
+
+// Updates simd::WIDTH objects starting at first with T = simd::FloatBatch, or just first
+// with T = float. Parents of all of them have to be up to date already.
+template<typename T>
+void Scene::update_objects(size_t first, std::span<InstanceData> instances) {
+    constexpr size_t LANES = std::is_same_v<T, float> ? 1 : simd::WIDTH;
+
+    using simd::load;
+    using simd::broadcast;
+    using simd::multiply_add;
+
+    const T x = load<T>(&local_rotations_[0][first]);
+    const T y = load<T>(&local_rotations_[1][first]);
+    const T z = load<T>(&local_rotations_[2][first]);
+    const T w = load<T>(&local_rotations_[3][first]);
+    const T one = broadcast<T>(1.0f);
+    const T two = broadcast<T>(2.0f);
+
+    const T xx = x * x * two, yy = y * y * two, zz = z * z * two;
+    const T xy = x * y * two, xz = x * z * two, yz = y * z * two;
+    const T wx = w * x * two, wy = w * y * two, wz = w * z * two;
+
+    const T scale_x = load<T>(&local_scales_[0][first]);
+    const T scale_y = load<T>(&local_scales_[1][first]);
+    const T scale_z = load<T>(&local_scales_[2][first]);
+
+    const T local[12] = {
+        (one - yy - zz) * scale_x, (xy - wz) * scale_y, (xz + wy) * scale_z, load<T>(&local_positions_[0][first]),
+        (xy + wz) * scale_x, (one - xx - zz) * scale_y, (yz - wx) * scale_z, load<T>(&local_positions_[1][first]),
+        (xz - wy) * scale_x, (yz + wx) * scale_y, (one - xx - yy) * scale_z, load<T>(&local_positions_[2][first]),
+    };
+
+    alignas(32) float parent_elements[12][LANES];
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        const uint32_t parent = parents_[first + lane];
+        for (size_t element = 0; element < 12; ++element) {
+            parent_elements[element][lane] = parent == NO_PARENT ? IDENTITY[element] : world_matrices_[element][parent];
+        }
+    }
+
+    T world[12];
+    for (size_t row = 0; row < 3; ++row) {
+        const T p0 = load<T>(parent_elements[row * 4 + 0]);
+        const T p1 = load<T>(parent_elements[row * 4 + 1]);
+        const T p2 = load<T>(parent_elements[row * 4 + 2]);
+        const T p3 = load<T>(parent_elements[row * 4 + 3]);
+        for (size_t column = 0; column < 4; ++column) {
+            T value = multiply_add(p0, local[column], p1 * local[4 + column]);
+            value = multiply_add(p2, local[8 + column], value);
+            world[row * 4 + column] = column == 3 ? value + p3 : value;
+        }
+    }
+
+    const T center_x = load<T>(&local_centers_[0][first]);
+    const T center_y = load<T>(&local_centers_[1][first]);
+    const T center_z = load<T>(&local_centers_[2][first]);
+    T max_scale = broadcast<T>(0.0f);
+    for (size_t column = 0; column < 3; ++column) {
+        const T length = multiply_add(world[column], world[column],
+                                      multiply_add(world[4 + column], world[4 + column], world[8 + column] * world[8 + column]));
+        max_scale = simd::max(max_scale, length);
+    }
+
+    for (size_t row = 0; row < 3; ++row) {
+        const T* matrix_row = &world[row * 4];
+        const T center = multiply_add(matrix_row[0], center_x,
+                                      multiply_add(matrix_row[1], center_y, multiply_add(matrix_row[2], center_z, matrix_row[3])));
+        simd::store(&world_centers_[row][first], center);
+    }
+    simd::store(&world_radii_[first], load<T>(&local_radii_[first]) * simd::sqrt(max_scale));
+
+    for (size_t element = 0; element < 12; ++element) {
+        simd::store(&world_matrices_[element][first], world[element]);
+    }
+
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        InstanceData& instance = instances[first + lane];
+        for (size_t row = 0; row < 3; ++row) {
+            instance.rows[row] = glm::vec4{
+                world_matrices_[row * 4 + 0][first + lane],
+                world_matrices_[row * 4 + 1][first + lane],
+                world_matrices_[row * 4 + 2][first + lane],
+                world_matrices_[row * 4 + 3][first + lane],
+            };
+        }
+    }
+}
+
+}
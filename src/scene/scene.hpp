@@ -0,0 +1,101 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+namespace jobs {
+
+class JobSystem;
+
+}
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace scene {
+
+inline constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+struct Transform {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+};
+
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+};
+
+// World matrix as shaders read it: the top three rows of a row-major affine matrix.
+struct InstanceData {
+    glm::vec4 rows[3];
+};
+static_assert(sizeof(InstanceData) == 48);
+
+// Objects stored as structure of arrays under dense indices in creation order. Parents
+// have to exist before their children, so every parent sits ahead of its children and
+// one linear pass resolves the whole hierarchy. The parallel update splits objects into
+// waves that start at the first object whose parent is in the current wave; adding
+// objects level by level (all roots, then all their children, ...) keeps waves large.
+class Scene final :
+    NonCopyable {
+public:
+    // Returns the index of the new object. mesh is whatever the renderer draws it with.
+    uint32_t add_object(const Transform& local_transform,
+                        const BoundingSphere& local_bounds,
+                        uint32_t mesh,
+                        uint32_t parent = NO_PARENT);
+
+    void set_local_transform(uint32_t object, const Transform& local_transform) noexcept;
+
+    void set_local_rotation(uint32_t object, const glm::quat& rotation) noexcept;
+
+    void clear() noexcept;
+
+    // Recomputes world matrices and world bounds of every object, batching independent
+    // objects with SIMD, and writes the matrices to instances in object order.
+    void update(std::span<InstanceData> instances);
+
+    // Same as above, updating each wave in parallel chunks.
+    void update(std::span<InstanceData> instances, jobs::JobSystem& job_system);
+
+    size_t get_object_count() const noexcept { return parents_.size(); }
+
+    std::span<const uint32_t> get_parents() const noexcept { return parents_; }
+
+    std::span<const uint32_t> get_meshes() const noexcept { return meshes_; }
+
+    // World bounds from the last update(), one array per component.
+    std::span<const float> get_world_centers(size_t axis) const noexcept { return world_centers_[axis]; }
+
+    std::span<const float> get_world_radii() const noexcept { return world_radii_; }
+
+    std::span<const float> get_local_radii() const noexcept { return local_radii_; }
+private:
+    void update_range(size_t first, size_t last, std::span<InstanceData> instances);
+
+    template<typename T>
+    void update_objects(size_t first, std::span<InstanceData> instances);
+
+    std::vector<uint32_t> parents_;
+    // First object of every wave.
+    std::vector<uint32_t> wave_starts_;
+    std::vector<uint32_t> meshes_;
+    std::array<std::vector<float>, 3> local_positions_;
+    std::array<std::vector<float>, 4> local_rotations_;
+    std::array<std::vector<float>, 3> local_scales_;
+    std::array<std::vector<float>, 3> local_centers_;
+    std::vector<float> local_radii_;
+    // Row-major 3x4, element r * 4 + c.
+    std::array<std::vector<float>, 12> world_matrices_;
+    std::array<std::vector<float>, 3> world_centers_;
+    std::vector<float> world_radii_;
+};
+
+}
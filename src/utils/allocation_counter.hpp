@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+// Counts heap allocations made through the global operator new, on every thread.
+// Compiling allocation_counter.cpp into a program replaces its operator new and delete,
+// programs without it never count. Allocations the Vulkan driver or VMA make with
+// malloc are not seen.
+namespace allocation_counter {
+
+struct AllocationStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// Totals since the program started.
+AllocationStats get_stats() noexcept;
+
+inline AllocationStats operator-(const AllocationStats& a, const AllocationStats& b) noexcept {
+    return { a.count - b.count, a.bytes - b.bytes };
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+// Generational index into a ResourcePool. A handle outlives the resource it names
+// safely: once the slot is recycled its generation no longer matches.
+template<typename T>
+class Handle final {
+public:
+    constexpr Handle() noexcept = default;
+
+    constexpr bool is_valid() const noexcept { return generation_ != 0; }
+
+    constexpr uint32_t get_index() const noexcept { return index_; }
+
+    constexpr uint32_t get_generation() const noexcept { return generation_; }
+
+    constexpr explicit operator bool() const noexcept { return is_valid(); }
+
+    friend constexpr bool operator==(Handle, Handle) noexcept = default;
+private:
+    template<typename, uint32_t>
+    friend class ResourcePool;
+
+    constexpr Handle(uint32_t index, uint32_t generation) noexcept :
+        index_{ index },
+        generation_{ generation } {}
+
+    uint32_t index_ = 0;
+    uint32_t generation_ = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// 64-bit FNV-1a, stable across runs and platforms so it can key on-disk data.
+constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV1A_PRIME = 0x100000001b3ull;
+
+constexpr uint64_t hash_bytes(std::span<const std::byte> bytes, uint64_t seed = FNV1A_OFFSET_BASIS) noexcept {
+    uint64_t hash = seed;
+    for (std::byte byte : bytes) {
+        hash ^= static_cast<uint64_t>(byte);
+        hash *= FNV1A_PRIME;
+    }
+
+    return hash;
+}
+
+// Same result as hash_bytes over the characters, usable at compile time.
+constexpr uint64_t hash_string(std::string_view string, uint64_t seed = FNV1A_OFFSET_BASIS) noexcept {
+    uint64_t hash = seed;
+    for (char c : string) {
+        hash ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+        hash *= FNV1A_PRIME;
+    }
+
+    return hash;
+}
+
+constexpr uint64_t hash_combine(uint64_t seed, uint64_t value) noexcept {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
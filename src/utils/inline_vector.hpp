@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// Vector of trivially copyable values stored inline, for the short lists of create
+// infos and constants built on hot paths. Never allocates, growing past the capacity throws.
+template<typename T, size_t Capacity>
+    requires std::is_trivially_copyable_v<T>
+class InlineVector final {
+public:
+    void push_back(const T& value) {
+        if (size_ == Capacity) {
+            throw std::runtime_error{ "InlineVector capacity exceeded." };
+        }
+        values_[size_++] = value;
+    }
+
+    // New values are value-initialized.
+    void resize(size_t size) {
+        if (size > Capacity) {
+            throw std::runtime_error{ "InlineVector capacity exceeded." };
+        }
+        for (size_t i = size_; i < size; ++i) {
+            values_[i] = T{};
+        }
+        size_ = size;
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_t size() const noexcept { return size_; }
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    T* data() noexcept { return values_.data(); }
+    const T* data() const noexcept { return values_.data(); }
+
+    T* begin() noexcept { return values_.data(); }
+    const T* begin() const noexcept { return values_.data(); }
+
+    T* end() noexcept { return values_.data() + size_; }
+    const T* end() const noexcept { return values_.data() + size_; }
+
+    T& back() noexcept { return values_[size_ - 1]; }
+    const T& back() const noexcept { return values_[size_ - 1]; }
+
+    T& operator[](size_t index) noexcept { return values_[index]; }
+    const T& operator[](size_t index) const noexcept { return values_[index]; }
+private:
+    std::array<T, Capacity> values_;
+    size_t size_ = 0;
+};
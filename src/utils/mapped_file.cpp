@@ -0,0 +1,127 @@
+#include "utils/mapped_file.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* filename) {
+#ifdef _WIN32
+    file_handle_ = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle_ == INVALID_HANDLE_VALUE) {
+        file_handle_ = nullptr;
+        throw std::runtime_error(std::format("Failed to open file: {}", filename));
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle_, &file_size)) {
+        unmap();
+        throw std::runtime_error(std::format("Failed to query file size: {}", filename));
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+
+    mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle_ == nullptr) {
+        unmap();
+        throw std::runtime_error(std::format("Failed to map file: {}", filename));
+    }
+
+    data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        unmap();
+        throw std::runtime_error(std::format("Failed to map file: {}", filename));
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("Failed to open file: {}", filename));
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error(std::format("Failed to query file size: {}", filename));
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error(std::format("Failed to map file: {}", filename));
+    }
+
+    // Assets are consumed right after opening, start paging them in now.
+    madvise(data, size_, MADV_WILLNEED);
+    data_ = static_cast<const std::byte*>(data);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data_{ std::exchange(other.data_, nullptr) },
+    size_{ std::exchange(other.size_, 0) }
+#ifdef _WIN32
+    , file_handle_{ std::exchange(other.file_handle_, nullptr) },
+    mapping_handle_{ std::exchange(other.mapping_handle_, nullptr) }
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_handle_ = std::exchange(other.file_handle_, nullptr);
+        mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+void MappedFile::unmap() noexcept {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(file_handle_);
+    }
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <cstddef>
+#include <span>
+
+// Read-only memory mapping of a whole file.
+class MappedFile final :
+    NonCopyable {
+public:
+    explicit MappedFile(const char* filename);
+
+    MappedFile(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    std::span<const std::byte> get_data() const noexcept { return { data_, size_ }; }
+
+    size_t get_size() const noexcept { return size_; }
+
+    MappedFile& operator=(MappedFile&& other) noexcept;
+private:
+    void unmap() noexcept;
+
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
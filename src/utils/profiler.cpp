@@ -0,0 +1,162 @@
+#include "utils/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace profiler {
+
+namespace {
+
+// Zones kept per track, a power of two.
+constexpr uint64_t TRACK_CAPACITY = 16384;
+
+// Fields are atomics so traces can be written while threads keep recording; zones
+// overwritten during the copy are dropped.
+struct ZoneSlot {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> begin;
+    std::atomic<uint64_t> end;
+};
+
+struct Track {
+    uint32_t id;
+    std::string name;
+    std::array<ZoneSlot, TRACK_CAPACITY> zones;
+    std::atomic<uint64_t> zone_count = 0;
+};
+
+struct Zone {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+std::atomic<bool> enabled = false;
+
+// Tracks live as long as the program so traces still show threads that have exited.
+std::mutex tracks_mutex;
+std::vector<std::unique_ptr<Track>> tracks;
+
+thread_local Track* current_track = nullptr;
+
+Track& add_track(const char* name) {
+    std::lock_guard lock{ tracks_mutex };
+    auto track = std::make_unique<Track>();
+    track->id = static_cast<uint32_t>(tracks.size());
+    track->name = name;
+    tracks.push_back(std::move(track));
+    return *tracks.back();
+}
+
+// Created up front, recording must not allocate.
+Track& gpu_track = add_track("GPU");
+
+void record(Track& track, const char* name, uint64_t begin, uint64_t end) noexcept {
+    const uint64_t index = track.zone_count.load(std::memory_order_relaxed);
+    ZoneSlot& slot = track.zones[index & (TRACK_CAPACITY - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    track.zone_count.store(index + 1, std::memory_order_release);
+}
+
+std::vector<Zone> copy_zones(const Track& track) {
+    const uint64_t last = track.zone_count.load(std::memory_order_acquire);
+    const uint64_t first = last > TRACK_CAPACITY ? last - TRACK_CAPACITY : 0;
+
+    std::vector<Zone> zones;
+    zones.reserve(last - first);
+    for (uint64_t index = first; index < last; ++index) {
+        const ZoneSlot& slot = track.zones[index & (TRACK_CAPACITY - 1)];
+        zones.push_back({
+            slot.name.load(std::memory_order_relaxed),
+            slot.begin.load(std::memory_order_relaxed),
+            slot.end.load(std::memory_order_relaxed)
+        });
+    }
+
+    // The owner may have wrapped around onto slots while they were copied, or be writing
+    // the slot after its last zone. Those hold newer zones now.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t written = track.zone_count.load(std::memory_order_relaxed) + 1;
+    const uint64_t valid_first = written > TRACK_CAPACITY ? written - TRACK_CAPACITY : 0;
+    if (valid_first > first) {
+        zones.erase(zones.begin(), zones.begin() + std::min(valid_first - first, last - first));
+    }
+
+    return zones;
+}
+
+}
+
+uint64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void set_enabled(bool value) noexcept {
+    enabled.store(value, std::memory_order_relaxed);
+}
+
+bool is_enabled() noexcept {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void set_thread_name(const char* name) {
+    if (current_track) {
+        std::lock_guard lock{ tracks_mutex };
+        current_track->name = name;
+    }
+    else {
+        current_track = &add_track(name);
+    }
+}
+
+void record_zone(const char* name, uint64_t begin, uint64_t end) noexcept {
+    if (current_track) {
+        record(*current_track, name, begin, end);
+    }
+}
+
+void record_gpu_zone(const char* name, uint64_t begin, uint64_t end) noexcept {
+    record(gpu_track, name, begin, end);
+}
+
+void write_chrome_trace(const std::filesystem::path& path) {
+    std::ofstream file{ path };
+    if (!file) {
+        throw std::runtime_error{ std::format("Failed to open {} for writing.", path.string()) };
+    }
+
+    // Timestamps are in microseconds.
+    std::lock_guard lock{ tracks_mutex };
+    std::print(file, "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first_event = true;
+    for (const auto& track : tracks) {
+        std::print(file,
+                   "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                   first_event ? "" : ",", track->id, track->name);
+        first_event = false;
+        for (const Zone& zone : copy_zones(*track)) {
+            std::print(file,
+                       ",{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                       zone.name, track->id, zone.begin / 1000.0, (zone.end - zone.begin) / 1000.0);
+        }
+    }
+    std::println(file, "]}}");
+
+    if (!file) {
+        throw std::runtime_error{ std::format("Failed to write {}.", path.string()) };
+    }
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <cstdint>
+#include <filesystem>
+
+// Scoped CPU zones recorded into per-thread ring buffers, plus one track of GPU zones, all
+// on the steady clock in nanoseconds. Recording takes no locks: each thread only writes its
+// own buffer and the oldest zones are overwritten once it is full, so a trace holds the
+// last few seconds. Zone names have to outlive the profiler, string literals do.
+namespace profiler {
+
+// Nanoseconds on the clock zones are recorded with.
+uint64_t now() noexcept;
+
+// Zones are only recorded while enabled.
+void set_enabled(bool enabled) noexcept;
+
+bool is_enabled() noexcept;
+
+// Creates the calling thread's track, or renames it. Zones of threads that never
+// called it are dropped, so recording never has to allocate.
+void set_thread_name(const char* name);
+
+void record_zone(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+// Records to the GPU track, from one thread at a time. Times have to be converted to
+// now()'s clock already.
+void record_gpu_zone(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+// Writes the zones still in the buffers as Chrome trace event JSON, which Perfetto and
+// chrome://tracing open.
+void write_chrome_trace(const std::filesystem::path& path);
+
+class ScopedZone final :
+    NonCopyable {
+public:
+    explicit ScopedZone(const char* name) noexcept :
+        name_{ name },
+        begin_{ is_enabled() ? now() : 0 } {}
+
+    ~ScopedZone() {
+        if (begin_ != 0) {
+            record_zone(name_, begin_, now());
+        }
+    }
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+}
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+// Records the rest of the enclosing scope as a zone.
+#define PROFILE_ZONE(name) const profiler::ScopedZone PROFILER_CONCAT(profile_zone_, __LINE__){ name }
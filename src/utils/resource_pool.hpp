@@ -0,0 +1,157 @@
+#pragma once
+#include "utils/handle.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Slab-allocated storage for resources addressed by generational handles.
+// Slabs are never moved or freed before the pool, so resource addresses stay stable.
+//
+// release() retires a handle immediately but keeps the resource alive until
+// collect() is called with a retire value at or past the one it was released with
+// (a frame number or timeline semaphore value), after which the slot is recycled.
+template<typename T, uint32_t SLAB_SIZE = 256>
+class ResourcePool final :
+    NonCopyable {
+public:
+    ResourcePool() = default;
+
+    ~ResourcePool() { clear(); }
+
+    template<typename... Args>
+    Handle<T> create(Args&&... args) {
+        if (free_indices_.empty()) {
+            grow();
+        }
+
+        uint32_t index = free_indices_.back();
+        Slot& slot = slot_at(index);
+        slot.value.emplace(std::forward<Args>(args)...);
+        free_indices_.pop_back();
+        ++size_;
+
+        return { index, slot.generation };
+    }
+
+    void destroy(Handle<T> handle) noexcept {
+        Slot* slot = find(handle);
+        if (slot == nullptr) {
+            return;
+        }
+
+        retire(*slot);
+        slot->value.reset();
+        free_indices_.push_back(handle.get_index());
+    }
+
+    void release(Handle<T> handle, uint64_t retire_value) {
+        Slot* slot = find(handle);
+        if (slot == nullptr) {
+            return;
+        }
+
+        assert((pending_.empty() || pending_.back().retire_value <= retire_value) &&
+               "Retire values must be monotonic.");
+        pending_.push_back({ handle.get_index(), retire_value });
+        retire(*slot);
+    }
+
+    // Destroys every released resource whose retire value is <= completed_value.
+    void collect(uint64_t completed_value) noexcept {
+        auto it = pending_.begin();
+        for (; it != pending_.end() && it->retire_value <= completed_value; ++it) {
+            slot_at(it->index).value.reset();
+            free_indices_.push_back(it->index);
+        }
+        pending_.erase(pending_.begin(), it);
+    }
+
+    T* get(Handle<T> handle) noexcept {
+        Slot* slot = find(handle);
+        return slot != nullptr ? &*slot->value : nullptr;
+    }
+
+    const T* get(Handle<T> handle) const noexcept {
+        return const_cast<ResourcePool*>(this)->get(handle);
+    }
+
+    bool contains(Handle<T> handle) const noexcept { return get(handle) != nullptr; }
+
+    T& operator[](Handle<T> handle) noexcept {
+        T* value = get(handle);
+        assert(value != nullptr && "Stale or null resource handle.");
+        return *value;
+    }
+
+    const T& operator[](Handle<T> handle) const noexcept {
+        const T* value = get(handle);
+        assert(value != nullptr && "Stale or null resource handle.");
+        return *value;
+    }
+
+    // Live resources, not counting released ones waiting for collect().
+    size_t size() const noexcept { return size_; }
+
+    size_t get_pending_count() const noexcept { return pending_.size(); }
+
+    size_t get_capacity() const noexcept { return slabs_.size() * SLAB_SIZE; }
+
+    // Destroys everything immediately, including released resources.
+    void clear() noexcept {
+        collect(UINT64_MAX);
+        for (uint32_t index = 0; index < get_capacity(); ++index) {
+            Slot& slot = slot_at(index);
+            if (slot.value) {
+                destroy({ index, slot.generation });
+            }
+        }
+    }
+private:
+    struct Slot {
+        std::optional<T> value;
+        uint32_t generation = 1;
+    };
+
+    struct PendingRelease {
+        uint32_t index;
+        uint64_t retire_value;
+    };
+
+    Slot& slot_at(uint32_t index) noexcept { return slabs_[index / SLAB_SIZE][index % SLAB_SIZE]; }
+
+    void grow() {
+        uint32_t first_index = static_cast<uint32_t>(get_capacity());
+        slabs_.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+
+        // Room for every index up front keeps destroy() and collect() from allocating.
+        // Reversed so that lower indices are handed out first.
+        free_indices_.reserve(get_capacity());
+        for (uint32_t i = SLAB_SIZE; i > 0; --i) {
+            free_indices_.push_back(first_index + i - 1);
+        }
+    }
+
+    void retire(Slot& slot) noexcept {
+        slot.generation = (slot.generation == UINT32_MAX) ? 1 : slot.generation + 1;
+        --size_;
+    }
+
+    Slot* find(Handle<T> handle) noexcept {
+        if (!handle || handle.get_index() >= get_capacity()) {
+            return nullptr;
+        }
+
+        Slot& slot = slot_at(handle.get_index());
+        return (slot.value && slot.generation == handle.get_generation()) ? &slot : nullptr;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    std::vector<uint32_t> free_indices_;
+    std::vector<PendingRelease> pending_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,132 @@
+#pragma once
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIMD_NEON 1
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Fixed-width float batches for structure-of-arrays loops: 8 lanes with AVX, 4 with
+// SSE2 or NEON, 4 scalar lanes elsewhere. Loads and stores are unaligned. Everything
+// also works on plain floats, so one template handles both batches and loop tails:
+// load<T>(src) and broadcast<T>(a) with T being FloatBatch or float.
+namespace simd {
+
+template<typename T>
+T load(const float* src) noexcept;
+
+template<typename T>
+T broadcast(float a) noexcept;
+
+#if defined(__AVX__)
+inline constexpr size_t WIDTH = 8;
+
+struct FloatBatch {
+    __m256 value;
+};
+
+template<> inline FloatBatch load<FloatBatch>(const float* src) noexcept { return { _mm256_loadu_ps(src) }; }
+inline void store(float* dst, FloatBatch a) noexcept { _mm256_storeu_ps(dst, a.value); }
+template<> inline FloatBatch broadcast<FloatBatch>(float a) noexcept { return { _mm256_set1_ps(a) }; }
+inline FloatBatch operator+(FloatBatch a, FloatBatch b) noexcept { return { _mm256_add_ps(a.value, b.value) }; }
+inline FloatBatch operator-(FloatBatch a, FloatBatch b) noexcept { return { _mm256_sub_ps(a.value, b.value) }; }
+inline FloatBatch operator*(FloatBatch a, FloatBatch b) noexcept { return { _mm256_mul_ps(a.value, b.value) }; }
+inline FloatBatch min(FloatBatch a, FloatBatch b) noexcept { return { _mm256_min_ps(a.value, b.value) }; }
+inline FloatBatch max(FloatBatch a, FloatBatch b) noexcept { return { _mm256_max_ps(a.value, b.value) }; }
+inline FloatBatch sqrt(FloatBatch a) noexcept { return { _mm256_sqrt_ps(a.value) }; }
+#if defined(__FMA__)
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return { _mm256_fmadd_ps(a.value, b.value, c.value) }; }
+#else
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return a * b + c; }
+#endif
+#elif defined(SIMD_SSE2)
+inline constexpr size_t WIDTH = 4;
+
+struct FloatBatch {
+    __m128 value;
+};
+
+template<> inline FloatBatch load<FloatBatch>(const float* src) noexcept { return { _mm_loadu_ps(src) }; }
+inline void store(float* dst, FloatBatch a) noexcept { _mm_storeu_ps(dst, a.value); }
+template<> inline FloatBatch broadcast<FloatBatch>(float a) noexcept { return { _mm_set1_ps(a) }; }
+inline FloatBatch operator+(FloatBatch a, FloatBatch b) noexcept { return { _mm_add_ps(a.value, b.value) }; }
+inline FloatBatch operator-(FloatBatch a, FloatBatch b) noexcept { return { _mm_sub_ps(a.value, b.value) }; }
+inline FloatBatch operator*(FloatBatch a, FloatBatch b) noexcept { return { _mm_mul_ps(a.value, b.value) }; }
+inline FloatBatch min(FloatBatch a, FloatBatch b) noexcept { return { _mm_min_ps(a.value, b.value) }; }
+inline FloatBatch max(FloatBatch a, FloatBatch b) noexcept { return { _mm_max_ps(a.value, b.value) }; }
+inline FloatBatch sqrt(FloatBatch a) noexcept { return { _mm_sqrt_ps(a.value) }; }
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return a * b + c; }
+#elif defined(SIMD_NEON)
+inline constexpr size_t WIDTH = 4;
+
+struct FloatBatch {
+    float32x4_t value;
+};
+
+template<> inline FloatBatch load<FloatBatch>(const float* src) noexcept { return { vld1q_f32(src) }; }
+inline void store(float* dst, FloatBatch a) noexcept { vst1q_f32(dst, a.value); }
+template<> inline FloatBatch broadcast<FloatBatch>(float a) noexcept { return { vdupq_n_f32(a) }; }
+inline FloatBatch operator+(FloatBatch a, FloatBatch b) noexcept { return { vaddq_f32(a.value, b.value) }; }
+inline FloatBatch operator-(FloatBatch a, FloatBatch b) noexcept { return { vsubq_f32(a.value, b.value) }; }
+inline FloatBatch operator*(FloatBatch a, FloatBatch b) noexcept { return { vmulq_f32(a.value, b.value) }; }
+inline FloatBatch min(FloatBatch a, FloatBatch b) noexcept { return { vminq_f32(a.value, b.value) }; }
+inline FloatBatch max(FloatBatch a, FloatBatch b) noexcept { return { vmaxq_f32(a.value, b.value) }; }
+#if defined(__aarch64__) || defined(_M_ARM64)
+inline FloatBatch sqrt(FloatBatch a) noexcept { return { vsqrtq_f32(a.value) }; }
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return { vfmaq_f32(c.value, a.value, b.value) }; }
+#else
+inline FloatBatch sqrt(FloatBatch a) noexcept {
+    float lanes[4];
+    vst1q_f32(lanes, a.value);
+    for (float& lane : lanes) {
+        lane = std::sqrt(lane);
+    }
+    return { vld1q_f32(lanes) };
+}
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return { vmlaq_f32(c.value, a.value, b.value) }; }
+#endif
+#else
+inline constexpr size_t WIDTH = 4;
+
+struct FloatBatch {
+    float value[WIDTH];
+};
+
+template<typename Op>
+inline FloatBatch apply(FloatBatch a, FloatBatch b, Op op) noexcept {
+    FloatBatch result;
+    for (size_t i = 0; i < WIDTH; ++i) {
+        result.value[i] = op(a.value[i], b.value[i]);
+    }
+    return result;
+}
+
+template<> inline FloatBatch load<FloatBatch>(const float* src) noexcept { FloatBatch a; std::copy(src, src + WIDTH, a.value); return a; }
+inline void store(float* dst, FloatBatch a) noexcept { std::copy(a.value, a.value + WIDTH, dst); }
+template<> inline FloatBatch broadcast<FloatBatch>(float a) noexcept { FloatBatch b; std::fill(b.value, b.value + WIDTH, a); return b; }
+inline FloatBatch operator+(FloatBatch a, FloatBatch b) noexcept { return apply(a, b, [](float x, float y) { return x + y; }); }
+inline FloatBatch operator-(FloatBatch a, FloatBatch b) noexcept { return apply(a, b, [](float x, float y) { return x - y; }); }
+inline FloatBatch operator*(FloatBatch a, FloatBatch b) noexcept { return apply(a, b, [](float x, float y) { return x * y; }); }
+inline FloatBatch min(FloatBatch a, FloatBatch b) noexcept { return apply(a, b, [](float x, float y) { return std::min(x, y); }); }
+inline FloatBatch max(FloatBatch a, FloatBatch b) noexcept { return apply(a, b, [](float x, float y) { return std::max(x, y); }); }
+inline FloatBatch sqrt(FloatBatch a) noexcept { return apply(a, a, [](float x, float) { return std::sqrt(x); }); }
+inline FloatBatch multiply_add(FloatBatch a, FloatBatch b, FloatBatch c) noexcept { return a * b + c; }
+#endif
+
+// Scalar overloads for loop tails.
+template<> inline float load<float>(const float* src) noexcept { return *src; }
+template<> inline float broadcast<float>(float a) noexcept { return a; }
+inline void store(float* dst, float a) noexcept { *dst = a; }
+inline float min(float a, float b) noexcept { return std::min(a, b); }
+inline float max(float a, float b) noexcept { return std::max(a, b); }
+inline float sqrt(float a) noexcept { return std::sqrt(a); }
+inline float multiply_add(float a, float b, float c) noexcept { return a * b + c; }
+
+}
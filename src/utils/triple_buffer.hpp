@@ -0,0 +1,49 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-off of whole values from one producer thread to one consumer thread.
+// The producer fills its slot and publishes it, the consumer switches to the latest
+// published slot whenever it wants a new value. Neither side ever waits for the other;
+// values published while the consumer is busy replace each other, so only the latest
+// one is seen. Slots are reused, so values keep their allocations between hand-offs.
+template<typename T>
+class TripleBuffer final :
+    NonCopyable {
+public:
+    // Producer only.
+    T& get_write_slot() noexcept { return slots_[write_index_]; }
+
+    // Producer only. Hands the write slot over and takes back a slot to write the next value to.
+    void publish() noexcept {
+        const uint8_t previous = shared_index_.exchange(write_index_ | FRESH_BIT, std::memory_order_acq_rel);
+        write_index_ = previous & INDEX_MASK;
+    }
+
+    // Consumer only. Switches the read slot to the latest published value, returns false
+    // when nothing was published since the last call.
+    bool acquire() noexcept {
+        if (!(shared_index_.load(std::memory_order_relaxed) & FRESH_BIT)) {
+            return false;
+        }
+
+        const uint8_t previous = shared_index_.exchange(read_index_, std::memory_order_acq_rel);
+        read_index_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer only.
+    const T& get_read_slot() const noexcept { return slots_[read_index_]; }
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    // Set while the shared slot holds a value the consumer has not seen.
+    static constexpr uint8_t FRESH_BIT = 0x4;
+
+    std::array<T, 3> slots_;
+    alignas(64) uint8_t write_index_ = 0;
+    alignas(64) std::atomic<uint8_t> shared_index_ = 1;
+    alignas(64) uint8_t read_index_ = 2;
+};
@@ -2,6 +2,7 @@
 #include "vlk/memory_allocator.hpp"
 
 #include <stdexcept>
+#include <utility>
 
 namespace vlk {
 
@@ -21,23 +22,87 @@ Buffer::Buffer(const vlk::MemoryAllocator& allocator,
         .flags = flags,
         .usage = VMA_MEMORY_USAGE_AUTO
     };
-    VkResult result = vmaCreateBuffer(allocator, &buffer_create_info, &alloc_create_info, &buffer_, &allocation_, nullptr);
+    VmaAllocationInfo alloc_info;
+    VkResult result = vmaCreateBuffer(allocator, &buffer_create_info, &alloc_create_info, &buffer_, &allocation_, &alloc_info);
     if (result != VK_SUCCESS) {
         throw std::runtime_error{ "Failed to create buffer." };
     }
+
+    mapped_data_ = alloc_info.pMappedData;
+    vmaGetAllocationMemoryProperties(allocator, allocation_, &memory_flags_);
+
+    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+        VmaAllocatorInfo allocator_info;
+        vmaGetAllocatorInfo(allocator, &allocator_info);
+
+        const VkBufferDeviceAddressInfo address_info = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = buffer_
+        };
+        device_address_ = vkGetBufferDeviceAddress(allocator_info.device, &address_info);
+    }
+}
+
+Buffer::Buffer(Buffer&& other) noexcept :
+    allocator_{ other.allocator_ },
+    buffer_{ std::exchange(other.buffer_, VK_NULL_HANDLE) },
+    allocation_{ std::exchange(other.allocation_, VK_NULL_HANDLE) },
+    size_{ std::exchange(other.size_, 0) },
+    mapped_data_{ std::exchange(other.mapped_data_, nullptr) },
+    memory_flags_{ std::exchange(other.memory_flags_, 0) },
+    device_address_{ std::exchange(other.device_address_, 0) }
+{
 }
 
 Buffer::~Buffer() {
-    vmaDestroyBuffer(allocator_, buffer_, allocation_);
+    destroy();
 }
 
 void Buffer::copy_memory_to_allocation(const void* memory,
                                        VkDeviceSize size,
                                        VkDeviceSize offset) const {
-    VkResult result = vmaCopyMemoryToAllocation(allocator_, memory, allocation_, offset, size);
+    VkResult result = vmaCopyMemoryToAllocation(allocator_.get(), memory, allocation_, offset, size);
     if (result != VK_SUCCESS) {
         throw std::runtime_error{ "Failed to copy memory to allocation." };
     }
 }
 
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) const {
+    VkResult result = vmaFlushAllocation(allocator_.get(), allocation_, offset, size);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to flush allocation." };
+    }
+}
+
+void Buffer::invalidate(VkDeviceSize offset, VkDeviceSize size) const {
+    VkResult result = vmaInvalidateAllocation(allocator_.get(), allocation_, offset, size);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to invalidate allocation." };
+    }
+}
+
+Buffer& Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        allocator_ = other.allocator_;
+        buffer_ = std::exchange(other.buffer_, VK_NULL_HANDLE);
+        allocation_ = std::exchange(other.allocation_, VK_NULL_HANDLE);
+        size_ = std::exchange(other.size_, 0);
+        mapped_data_ = std::exchange(other.mapped_data_, nullptr);
+        memory_flags_ = std::exchange(other.memory_flags_, 0);
+        device_address_ = std::exchange(other.device_address_, 0);
+    }
+
+    return *this;
+}
+
+void Buffer::destroy() noexcept {
+    if (buffer_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator_.get(), buffer_, allocation_);
+        buffer_ = VK_NULL_HANDLE;
+        allocation_ = VK_NULL_HANDLE;
+    }
+}
+
 }
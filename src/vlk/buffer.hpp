@@ -1,8 +1,12 @@
 #pragma once
+#include "utils/handle.hpp"
 #include "utils/non_copyable.hpp"
 
 #include "vlk/vma.hpp"
 
+#include <functional>
+#include <span>
+
 namespace vlk {
 
 class MemoryAllocator;
@@ -10,25 +14,67 @@ class MemoryAllocator;
 class Buffer final :
     NonCopyable {
 public:
+    // Persistently mapped memory for data rewritten every frame. VMA places it in
+    // device-local host-visible memory (ReBAR) when the device exposes it.
+    static constexpr VmaAllocationCreateFlags DYNAMIC_FLAGS =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    // Device-local memory that ends up mapped only when it is also host-visible.
+    // Check is_mapped() and fall back to a staging copy otherwise.
+    static constexpr VmaAllocationCreateFlags UPLOAD_FLAGS =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
     Buffer(const vlk::MemoryAllocator& allocator,
            VkDeviceSize size,
            VkBufferUsageFlags usage,
            VmaAllocationCreateFlags flags);
 
+    Buffer(Buffer&& other) noexcept;
+
     ~Buffer();
 
     void copy_memory_to_allocation(const void* memory, VkDeviceSize size, VkDeviceSize offset = 0) const;
 
+    // No-ops on host-coherent memory.
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    template<typename T>
+    std::span<T> get_mapped_span() const noexcept {
+        return { static_cast<T*>(mapped_data_), static_cast<size_t>(size_ / sizeof(T)) };
+    }
+
+    bool is_mapped() const noexcept { return mapped_data_ != nullptr; }
+
+    bool is_host_coherent() const noexcept { return memory_flags_ & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT; }
+
+    bool is_device_local() const noexcept { return memory_flags_ & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT; }
+
     VkDeviceSize get_size() const noexcept { return size_; }
 
+    // Zero unless the buffer was created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT.
+    VkDeviceAddress get_device_address() const noexcept { return device_address_; }
+
     VkBuffer* ptr() noexcept { return &buffer_; }
 
     operator VkBuffer() const noexcept { return buffer_; }
+
+    Buffer& operator=(Buffer&& other) noexcept;
 private:
-    const vlk::MemoryAllocator& allocator_;
+    void destroy() noexcept;
+
+    std::reference_wrapper<const vlk::MemoryAllocator> allocator_;
     VkBuffer buffer_ = VK_NULL_HANDLE;
-    VmaAllocation allocation_;
+    VmaAllocation allocation_ = VK_NULL_HANDLE;
     VkDeviceSize size_ = 0;
+    void* mapped_data_ = nullptr;
+    VkMemoryPropertyFlags memory_flags_ = 0;
+    VkDeviceAddress device_address_ = 0;
 };
 
+using BufferHandle = Handle<Buffer>;
+
 }
@@ -3,6 +3,7 @@
 #include "vlk/buffer.hpp"
 #include "vlk/command_pool.hpp"
 #include "vlk/device.hpp"
+#include "vlk/image.hpp"
 
 #include <stdexcept>
 
@@ -28,7 +29,8 @@ void CommandBuffer::end() const {
 
 void CommandBuffer::begin_rendering(VkClearValue clear_color,
                                     VkImageView image_view,
-                                    VkExtent2D render_extent) const noexcept {
+                                    VkExtent2D render_extent,
+                                    VkImageView depth_image_view) const noexcept {
     const VkRenderingAttachmentInfo attachment_info = {
         .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
         .imageView = image_view,
@@ -38,12 +40,22 @@ void CommandBuffer::begin_rendering(VkClearValue clear_color,
         .clearValue = clear_color
     };
 
+    const VkRenderingAttachmentInfo depth_attachment_info = {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = depth_image_view,
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = { .depthStencil = { 1.0f, 0 } }
+    };
+
     const VkRenderingInfo rendering_info = {
         .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
         .renderArea = {.offset = { 0, 0 }, .extent = render_extent },
         .layerCount = 1,
         .colorAttachmentCount = 1,
-        .pColorAttachments = &attachment_info
+        .pColorAttachments = &attachment_info,
+        .pDepthAttachment = depth_image_view != VK_NULL_HANDLE ? &depth_attachment_info : nullptr
     };
     vkCmdBeginRendering(handle_, &rendering_info);
 }
@@ -53,4 +65,46 @@ void CommandBuffer::copy_buffer(const Buffer& src_buffer, const Buffer& dst_buff
     vkCmdCopyBuffer(handle_, src_buffer, dst_buffer, 1, &region);
 }
 
+void CommandBuffer::copy_buffer(const Buffer& src_buffer, const Buffer& dst_buffer, const VkBufferCopy& region) const noexcept {
+    vkCmdCopyBuffer(handle_, src_buffer, dst_buffer, 1, &region);
+}
+
+void CommandBuffer::copy_buffer_to_image(const Buffer& src_buffer,
+                                         const Image& dst_image,
+                                         std::span<const VkBufferImageCopy> regions) const noexcept {
+    vkCmdCopyBufferToImage(handle_,
+                           src_buffer,
+                           dst_image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
+}
+
+void CommandBuffer::transition_image_layout(VkImage image,
+                                            VkImageLayout old_layout,
+                                            VkImageLayout new_layout,
+                                            VkAccessFlags2 src_access,
+                                            VkAccessFlags2 dst_access,
+                                            VkPipelineStageFlags2 src_stage,
+                                            VkPipelineStageFlags2 dst_stage,
+                                            const VkImageSubresourceRange& range) const noexcept {
+    const VkImageMemoryBarrier2 barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = src_stage,
+        .srcAccessMask = src_access,
+        .dstStageMask = dst_stage,
+        .dstAccessMask = dst_access,
+        .oldLayout = old_layout,
+        .newLayout = new_layout,
+        .image = image,
+        .subresourceRange = range
+    };
+    const VkDependencyInfo dependency_info = {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &barrier
+    };
+    vkCmdPipelineBarrier2(handle_, &dependency_info);
+}
+
 }
@@ -3,22 +3,47 @@
 
 #include <volk/volk.h>
 
+#include <span>
+
 namespace vlk {
 
 class Buffer;
+class Image;
 
 class CommandBuffer final :
     NonCopyable {
 public:
+    // Null until a CommandPool allocates into it.
+    CommandBuffer() noexcept = default;
+
     void begin(VkCommandBufferUsageFlags flags = {}) const;
     void end() const;
 
+    // Depth attachment is optional, when present it is cleared to 1.0 and not stored.
     void begin_rendering(VkClearValue clear_color,
                          VkImageView image_view,
-                         VkExtent2D render_extent) const noexcept;
+                         VkExtent2D render_extent,
+                         VkImageView depth_image_view = VK_NULL_HANDLE) const noexcept;
 
     void copy_buffer(const Buffer& src_buffer, const Buffer& dst_buffer) const noexcept;
 
+    void copy_buffer(const Buffer& src_buffer, const Buffer& dst_buffer, const VkBufferCopy& region) const noexcept;
+
+    // Image has to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+    void copy_buffer_to_image(const Buffer& src_buffer,
+                              const Image& dst_image,
+                              std::span<const VkBufferImageCopy> regions) const noexcept;
+
+    void transition_image_layout(VkImage image,
+                                 VkImageLayout old_layout,
+                                 VkImageLayout new_layout,
+                                 VkAccessFlags2 src_access,
+                                 VkAccessFlags2 dst_access,
+                                 VkPipelineStageFlags2 src_stage,
+                                 VkPipelineStageFlags2 dst_stage,
+                                 const VkImageSubresourceRange& range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS,
+                                                                          0, VK_REMAINING_ARRAY_LAYERS }) const noexcept;
+
     const VkCommandBuffer* ptr() const noexcept { return &handle_; }
 
     operator VkCommandBuffer() const noexcept { return handle_; }
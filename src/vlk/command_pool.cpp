@@ -2,10 +2,19 @@
 #include "vlk/device.hpp"
 #include "vlk/command_buffer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <stdexcept>
 
 namespace vlk {
 
+namespace {
+
+constexpr size_t MAX_CHUNK_SIZE = 16;
+
+}
+
 CommandPool::CommandPool(const Device& device,
                          VkCommandPoolCreateFlags flags,
                          uint32_t queue_family_index) :
@@ -27,35 +36,43 @@ CommandPool::~CommandPool() {
 }
 
 std::vector<CommandBuffer> CommandPool::allocate_command_buffers(uint32_t count) const {
-    std::vector<VkCommandBuffer> vk_handles(count);
-    const VkCommandBufferAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = handle_,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = count
-    };
-    VkResult result = vkAllocateCommandBuffers(device_, &alloc_info, vk_handles.data());
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error{ "Failed to allocate Vulkan command buffers." };
-    }
+    std::vector<CommandBuffer> cmd_buffers(count);
+    allocate_command_buffers(cmd_buffers);
+    return cmd_buffers;
+}
 
-    std::vector<CommandBuffer> cmd_buffers;
-    cmd_buffers.reserve(vk_handles.size());
-    for (VkCommandBuffer handle : vk_handles) {
-        cmd_buffers.push_back(CommandBuffer{ handle });
-    }
+// Handles go through a stack array, in chunks when there are more than fit.
+void CommandPool::allocate_command_buffers(std::span<CommandBuffer> cmd_buffers) const {
+    std::array<VkCommandBuffer, MAX_CHUNK_SIZE> vk_handles;
+    for (size_t first = 0; first < cmd_buffers.size(); first += vk_handles.size()) {
+        const auto count = static_cast<uint32_t>(std::min(cmd_buffers.size() - first, vk_handles.size()));
+        const VkCommandBufferAllocateInfo alloc_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = handle_,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = count
+        };
+        VkResult result = vkAllocateCommandBuffers(device_, &alloc_info, vk_handles.data());
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error{ "Failed to allocate Vulkan command buffers." };
+        }
 
-    return cmd_buffers;
+        for (uint32_t i = 0; i < count; ++i) {
+            cmd_buffers[first + i] = CommandBuffer{ vk_handles[i] };
+        }
+    }
 }
 
 void CommandPool::free_command_buffers(std::span<const CommandBuffer> cmd_buffers) const {
-    std::vector<VkCommandBuffer> vk_handles;
-    vk_handles.reserve(cmd_buffers.size());
-    for (VkCommandBuffer cmd_buffer : cmd_buffers) {
-        vk_handles.push_back(cmd_buffer);
-    }
+    std::array<VkCommandBuffer, MAX_CHUNK_SIZE> vk_handles;
+    for (size_t first = 0; first < cmd_buffers.size(); first += vk_handles.size()) {
+        const auto count = static_cast<uint32_t>(std::min(cmd_buffers.size() - first, vk_handles.size()));
+        for (uint32_t i = 0; i < count; ++i) {
+            vk_handles[i] = cmd_buffers[first + i];
+        }
 
-    vkFreeCommandBuffers(device_, handle_, static_cast<uint32_t>(vk_handles.size()), vk_handles.data());
+        vkFreeCommandBuffers(device_, handle_, count, vk_handles.data());
+    }
 }
 
 }
@@ -22,6 +22,9 @@ public:
 
     std::vector<CommandBuffer> allocate_command_buffers(uint32_t count) const;
 
+    // Fills cmd_buffers with new command buffers, without allocating on the heap.
+    void allocate_command_buffers(std::span<CommandBuffer> cmd_buffers) const;
+
     void free_command_buffers(std::span<const CommandBuffer> cmd_buffers) const;
 
     operator VkCommandPool() const noexcept { return handle_; }
@@ -0,0 +1,80 @@
+#include "vlk/image.hpp"
+#include "vlk/memory_allocator.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace vlk {
+
+Image::Image(const vlk::MemoryAllocator& allocator,
+             VkFormat format,
+             VkExtent2D extent,
+             uint32_t mip_levels,
+             VkImageUsageFlags usage,
+             VmaAllocationCreateFlags flags) :
+    allocator_{ allocator },
+    format_{ format },
+    extent_{ extent },
+    mip_levels_{ mip_levels }
+{
+    const VkImageCreateInfo image_create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = format,
+        .extent = { extent.width, extent.height, 1 },
+        .mipLevels = mip_levels,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = flags,
+        .usage = VMA_MEMORY_USAGE_AUTO
+    };
+    VkResult result = vmaCreateImage(allocator, &image_create_info, &alloc_create_info, &handle_, &allocation_, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to create image." };
+    }
+}
+
+Image::Image(Image&& other) noexcept :
+    allocator_{ other.allocator_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) },
+    allocation_{ std::exchange(other.allocation_, VK_NULL_HANDLE) },
+    format_{ other.format_ },
+    extent_{ other.extent_ },
+    mip_levels_{ other.mip_levels_ }
+{
+}
+
+Image::~Image() {
+    destroy();
+}
+
+Image& Image::operator=(Image&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        allocator_ = other.allocator_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+        allocation_ = std::exchange(other.allocation_, VK_NULL_HANDLE);
+        format_ = other.format_;
+        extent_ = other.extent_;
+        mip_levels_ = other.mip_levels_;
+    }
+
+    return *this;
+}
+
+void Image::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vmaDestroyImage(allocator_.get(), handle_, allocation_);
+        handle_ = VK_NULL_HANDLE;
+        allocation_ = VK_NULL_HANDLE;
+    }
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "utils/handle.hpp"
+#include "utils/non_copyable.hpp"
+
+#include "vlk/vma.hpp"
+
+#include <functional>
+
+namespace vlk {
+
+class MemoryAllocator;
+
+class Image final :
+    NonCopyable {
+public:
+    Image(const vlk::MemoryAllocator& allocator,
+          VkFormat format,
+          VkExtent2D extent,
+          uint32_t mip_levels,
+          VkImageUsageFlags usage,
+          VmaAllocationCreateFlags flags = 0);
+
+    Image(Image&& other) noexcept;
+
+    ~Image();
+
+    VkFormat get_format() const noexcept { return format_; }
+
+    VkExtent2D get_extent() const noexcept { return extent_; }
+
+    uint32_t get_mip_levels() const noexcept { return mip_levels_; }
+
+    operator VkImage() const noexcept { return handle_; }
+
+    Image& operator=(Image&& other) noexcept;
+private:
+    void destroy() noexcept;
+
+    std::reference_wrapper<const vlk::MemoryAllocator> allocator_;
+    VkImage handle_ = VK_NULL_HANDLE;
+    VmaAllocation allocation_ = VK_NULL_HANDLE;
+    VkFormat format_ = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent_ = {};
+    uint32_t mip_levels_ = 0;
+};
+
+using ImageHandle = Handle<Image>;
+
+}
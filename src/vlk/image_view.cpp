@@ -0,0 +1,58 @@
+#include "vlk/image_view.hpp"
+#include "vlk/device.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace vlk {
+
+ImageView::ImageView(const Device& device,
+                     VkImage image,
+                     VkFormat format,
+                     VkImageAspectFlags aspect,
+                     uint32_t base_mip_level,
+                     uint32_t mip_level_count) :
+    device_{ device }
+{
+    const VkImageViewCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = format,
+        .subresourceRange = { aspect, base_mip_level, mip_level_count, 0, 1 }
+    };
+    VkResult result = vkCreateImageView(device, &create_info, nullptr, &handle_);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to create Vulkan image view." };
+    }
+}
+
+ImageView::ImageView(ImageView&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) }
+{
+}
+
+ImageView::~ImageView() {
+    destroy();
+}
+
+ImageView& ImageView::operator=(ImageView&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        device_ = other.device_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+    }
+
+    return *this;
+}
+
+void ImageView::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vkDestroyImageView(device_.get(), handle_, nullptr);
+        handle_ = VK_NULL_HANDLE;
+    }
+}
+
+}
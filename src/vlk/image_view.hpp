@@ -0,0 +1,39 @@
+#pragma once
+#include "utils/handle.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <volk/volk.h>
+
+#include <functional>
+
+namespace vlk {
+
+class Device;
+
+class ImageView final :
+    NonCopyable {
+public:
+    ImageView(const Device& device,
+              VkImage image,
+              VkFormat format,
+              VkImageAspectFlags aspect,
+              uint32_t base_mip_level = 0,
+              uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS);
+
+    ImageView(ImageView&& other) noexcept;
+
+    ~ImageView();
+
+    operator VkImageView() const noexcept { return handle_; }
+
+    ImageView& operator=(ImageView&& other) noexcept;
+private:
+    void destroy() noexcept;
+
+    std::reference_wrapper<const Device> device_;
+    VkImageView handle_ = VK_NULL_HANDLE;
+};
+
+using ImageViewHandle = Handle<ImageView>;
+
+}
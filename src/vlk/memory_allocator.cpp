@@ -11,6 +11,7 @@ MemoryAllocator::MemoryAllocator(const Instance& instance,
                                  const Device& device,
                                  uint32_t api_version) {
     VmaAllocatorCreateInfo create_info = {
+        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
         .physicalDevice = device.get_physical_device(),
         .device = device,
         .instance = instance,
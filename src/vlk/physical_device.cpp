@@ -13,9 +13,10 @@ VkPhysicalDeviceProperties PhysicalDevice::get_properties() const noexcept {
     return props.properties;
 }
 
-VkPhysicalDeviceFeatures PhysicalDevice::get_features() const noexcept {
+VkPhysicalDeviceFeatures PhysicalDevice::get_features(void* next) const noexcept {
     VkPhysicalDeviceFeatures2 feats = {
-        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = next
     };
     vkGetPhysicalDeviceFeatures2(handle_, &feats);
 
@@ -31,6 +32,15 @@ VkPhysicalDeviceMemoryProperties PhysicalDevice::get_memory_properties() const n
     return props.memoryProperties;
 }
 
+VkFormatProperties PhysicalDevice::get_format_properties(VkFormat format) const noexcept {
+    VkFormatProperties2 props = {
+        .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2
+    };
+    vkGetPhysicalDeviceFormatProperties2(handle_, format, &props);
+
+    return props.formatProperties;
+}
+
 std::vector<VkExtensionProperties> PhysicalDevice::get_extension_properties() const {
     uint32_t count = 0;
     VkResult result = vkEnumerateDeviceExtensionProperties(handle_, nullptr, &count, nullptr);
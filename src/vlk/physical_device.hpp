@@ -9,10 +9,13 @@ class PhysicalDevice final {
 public:
     VkPhysicalDeviceProperties get_properties() const noexcept;
 
-    VkPhysicalDeviceFeatures get_features() const noexcept;
+    // Extension feature structs chained through next are filled in as well.
+    VkPhysicalDeviceFeatures get_features(void* next = nullptr) const noexcept;
 
     VkPhysicalDeviceMemoryProperties get_memory_properties() const noexcept;
 
+    VkFormatProperties get_format_properties(VkFormat format) const noexcept;
+
     std::vector<VkExtensionProperties> get_extension_properties() const;
 
     std::vector<VkQueueFamilyProperties> get_queue_family_properties() const;
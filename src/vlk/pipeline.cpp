@@ -1,24 +1,41 @@
 #include "vlk/pipeline.hpp"
 #include "vlk/device.hpp"
+#include "utils/inline_vector.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <stdexcept>
-#include <vector>
+#include <type_traits>
+#include <utility>
 
 namespace vlk {
 
+namespace {
+
+void append_bytes(std::vector<std::byte>& state, std::span<const std::byte> bytes) {
+    state.insert(state.end(), bytes.begin(), bytes.end());
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+void append_value(std::vector<std::byte>& state, const T& value) {
+    append_bytes(state, std::as_bytes(std::span{ &value, 1 }));
+}
+
+}
+
 Pipeline::Pipeline(const Device& device,
+                   VkPipelineLayout layout,
                    std::span<const VkPipelineShaderStageCreateInfo> stages,
                    VkFormat color_attachment_format,
                    const VkVertexInputBindingDescription& vertex_binding_desc,
-                   std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs) :
+                   std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+                   const DepthState& depth_state,
+                   const SpecializationConstants& specialization) :
     device_{ device }
 {
-    const VkPipelineRenderingCreateInfo rendering_create_info = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
-        .colorAttachmentCount = 1,
-        .pColorAttachmentFormats = &color_attachment_format,
-    };
-
     const VkPipelineVertexInputStateCreateInfo vertex_input_create_info = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .vertexBindingDescriptionCount = 1,
@@ -27,6 +44,42 @@ Pipeline::Pipeline(const Device& device,
         .pVertexAttributeDescriptions = vertex_attribute_descs.data()
     };
 
+    create(layout, stages, color_attachment_format, &vertex_input_create_info, depth_state, specialization);
+}
+
+Pipeline::Pipeline(const Device& device,
+                   VkPipelineLayout layout,
+                   std::span<const VkPipelineShaderStageCreateInfo> stages,
+                   VkFormat color_attachment_format,
+                   const DepthState& depth_state,
+                   const SpecializationConstants& specialization) :
+    device_{ device }
+{
+    create(layout, stages, color_attachment_format, nullptr, depth_state, specialization);
+}
+
+void Pipeline::create(VkPipelineLayout layout,
+                      std::span<const VkPipelineShaderStageCreateInfo> stages,
+                      VkFormat color_attachment_format,
+                      const VkPipelineVertexInputStateCreateInfo* vertex_input_create_info,
+                      const DepthState& depth_state,
+                      const SpecializationConstants& specialization) {
+    const VkSpecializationInfo specialization_info = specialization.get_info();
+    InlineVector<VkPipelineShaderStageCreateInfo, MAX_STAGES> specialized_stages;
+    for (const auto& stage : stages) {
+        specialized_stages.push_back(stage);
+        if (!specialization.is_empty() && stage.pSpecializationInfo == nullptr) {
+            specialized_stages.back().pSpecializationInfo = &specialization_info;
+        }
+    }
+
+    const VkPipelineRenderingCreateInfo rendering_create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &color_attachment_format,
+        .depthAttachmentFormat = depth_state.format
+    };
+
     const VkPipelineInputAssemblyStateCreateInfo input_assembly_create_info = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
         .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
@@ -56,9 +109,23 @@ Pipeline::Pipeline(const Device& device,
         .sampleShadingEnable = VK_FALSE
     };
 
+    const bool depth_test_enable = depth_state.format != VK_FORMAT_UNDEFINED;
+    const VkPipelineDepthStencilStateCreateInfo depth_stencil_create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable = depth_test_enable ? VK_TRUE : VK_FALSE,
+        .depthWriteEnable = (depth_test_enable && depth_state.write_enable) ? VK_TRUE : VK_FALSE,
+        .depthCompareOp = depth_state.compare_op,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable = VK_FALSE
+    };
+
+    const bool has_fragment_stage = std::ranges::any_of(stages, [](auto& stage) {
+        return stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+    });
     const VkPipelineColorBlendAttachmentState color_blend_attachment = {
         .blendEnable = VK_FALSE,
-        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        .colorWriteMask = has_fragment_stage ?
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT : 0u
     };
     const VkPipelineColorBlendStateCreateInfo color_blend_create_info = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
@@ -67,7 +134,7 @@ Pipeline::Pipeline(const Device& device,
         .pAttachments = &color_blend_attachment
     };
 
-    const std::vector<VkDynamicState> dynamic_states = {
+    const std::array<VkDynamicState, 2> dynamic_states = {
         VK_DYNAMIC_STATE_VIEWPORT,
         VK_DYNAMIC_STATE_SCISSOR
     };
@@ -77,39 +144,103 @@ Pipeline::Pipeline(const Device& device,
         .pDynamicStates = dynamic_states.data()
     };
 
-    const VkPipelineLayoutCreateInfo layout_create_info = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO
-    };
-    VkPipelineLayout layout;
-    VkResult result = vkCreatePipelineLayout(device, &layout_create_info, nullptr, &layout);
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error{ "Failed to create Vulkan pipeline layout." };
-    }
-
     const VkGraphicsPipelineCreateInfo pipeline_create_info = {
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
         .pNext = &rendering_create_info,
-        .stageCount = static_cast<uint32_t>(stages.size()),
-        .pStages = stages.data(),
-        .pVertexInputState = &vertex_input_create_info,
-        .pInputAssemblyState = &input_assembly_create_info,
+        .stageCount = static_cast<uint32_t>(specialized_stages.size()),
+        .pStages = specialized_stages.data(),
+        .pVertexInputState = vertex_input_create_info,
+        .pInputAssemblyState = vertex_input_create_info != nullptr ? &input_assembly_create_info : nullptr,
         .pViewportState = &viewport_create_info,
         .pRasterizationState = &rasterization_create_info,
         .pMultisampleState = &multisample_create_info,
+        .pDepthStencilState = &depth_stencil_create_info,
         .pColorBlendState = &color_blend_create_info,
         .pDynamicState = &dynamic_state_create_info,
         .layout = layout
     };
-    result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &handle_);
+    VkResult result = vkCreateGraphicsPipelines(device_.get(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &handle_);
     if (result != VK_SUCCESS) {
         throw std::runtime_error{ "Failed to create Vulkan pipeline." };
     }
+}
 
-    vkDestroyPipelineLayout(device, layout, nullptr);
+Pipeline::Pipeline(Pipeline&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) }
+{
 }
 
 Pipeline::~Pipeline() {
-    vkDestroyPipeline(device_, handle_, nullptr);
+    destroy();
+}
+
+Pipeline& Pipeline::operator=(Pipeline&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        device_ = other.device_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+    }
+
+    return *this;
+}
+
+void Pipeline::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device_.get(), handle_, nullptr);
+        handle_ = VK_NULL_HANDLE;
+    }
+}
+
+void write_pipeline_state(std::vector<std::byte>& state,
+                          VkPipelineLayout layout,
+                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                          VkFormat color_attachment_format,
+                          const VkVertexInputBindingDescription& vertex_binding_desc,
+                          std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+                          const DepthState& depth_state,
+                          const SpecializationConstants& specialization) {
+    write_pipeline_state(state, layout, stages, color_attachment_format, depth_state, specialization);
+    append_value(state, vertex_binding_desc.stride);
+    append_value(state, vertex_binding_desc.inputRate);
+    append_value(state, static_cast<uint32_t>(vertex_attribute_descs.size()));
+    for (const auto& attribute : vertex_attribute_descs) {
+        append_value(state, attribute.location);
+        append_value(state, attribute.format);
+        append_value(state, attribute.offset);
+    }
+}
+
+void write_pipeline_state(std::vector<std::byte>& state,
+                          VkPipelineLayout layout,
+                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                          VkFormat color_attachment_format,
+                          const DepthState& depth_state,
+                          const SpecializationConstants& specialization) {
+    append_value(state, std::bit_cast<uint64_t>(layout));
+    append_value(state, static_cast<uint32_t>(stages.size()));
+    for (const auto& stage : stages) {
+        append_value(state, stage.stage);
+        append_value(state, std::bit_cast<uint64_t>(stage.module));
+        append_bytes(state, std::as_bytes(std::span{ stage.pName, std::strlen(stage.pName) + 1 }));
+        if (stage.pSpecializationInfo != nullptr) {
+            const VkSpecializationInfo& info = *stage.pSpecializationInfo;
+            append_value(state, info.mapEntryCount);
+            append_bytes(state, std::as_bytes(std::span{ info.pMapEntries, info.mapEntryCount }));
+            append_value(state, info.dataSize);
+            append_bytes(state, { static_cast<const std::byte*>(info.pData), info.dataSize });
+        }
+        else {
+            append_value(state, uint32_t{ 0 });
+        }
+    }
+
+    append_value(state, color_attachment_format);
+    append_value(state, depth_state.format);
+    append_value(state, depth_state.compare_op);
+    append_value(state, depth_state.write_enable);
+    specialization.write_state(state);
 }
 
 }
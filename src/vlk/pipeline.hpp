@@ -1,29 +1,92 @@
 #pragma once
+#include "utils/handle.hpp"
 #include "utils/non_copyable.hpp"
+#include "vlk/specialization_constants.hpp"
 
 #include <volk/volk.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <span>
+#include <vector>
 
 namespace vlk {
 
 class Device;
 
+struct DepthState {
+    // VK_FORMAT_UNDEFINED disables depth testing.
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkCompareOp compare_op = VK_COMPARE_OP_LESS;
+    bool write_enable = true;
+};
+
+// Pipelines without a fragment stage are depth-only and leave color attachments untouched.
+// The specialization constants apply to every stage that has no pSpecializationInfo of its own.
+// The layout is not owned and only has to outlive construction.
 class Pipeline final :
     NonCopyable {
 public:
+    // Vertex, tessellation, geometry and fragment.
+    static constexpr size_t MAX_STAGES = 5;
+
     Pipeline(const Device& device,
+             VkPipelineLayout layout,
              std::span<const VkPipelineShaderStageCreateInfo> stages,
              VkFormat color_attachment_format,
              const VkVertexInputBindingDescription& vertex_binding_desc,
-             std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs);
+             std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+             const DepthState& depth_state = {},
+             const SpecializationConstants& specialization = {});
+
+    // Mesh shading pipeline: task and mesh stages take the place of vertex input and assembly.
+    Pipeline(const Device& device,
+             VkPipelineLayout layout,
+             std::span<const VkPipelineShaderStageCreateInfo> stages,
+             VkFormat color_attachment_format,
+             const DepthState& depth_state = {},
+             const SpecializationConstants& specialization = {});
+
+    Pipeline(Pipeline&& other) noexcept;
 
     ~Pipeline();
 
     operator VkPipeline() const noexcept { return handle_; }
+
+    Pipeline& operator=(Pipeline&& other) noexcept;
 private:
-    const Device& device_;
+    void create(VkPipelineLayout layout,
+                std::span<const VkPipelineShaderStageCreateInfo> stages,
+                VkFormat color_attachment_format,
+                const VkPipelineVertexInputStateCreateInfo* vertex_input_create_info,
+                const DepthState& depth_state,
+                const SpecializationConstants& specialization);
+
+    void destroy() noexcept;
+
+    std::reference_wrapper<const Device> device_;
     VkPipeline handle_ = VK_NULL_HANDLE;
 };
 
+using PipelineHandle = Handle<Pipeline>;
+
+// Appends everything a Pipeline is created from to state, equal states give identical
+// pipelines. Shader modules are identified by handle, so they should come from a ShaderLibrary.
+void write_pipeline_state(std::vector<std::byte>& state,
+                          VkPipelineLayout layout,
+                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                          VkFormat color_attachment_format,
+                          const VkVertexInputBindingDescription& vertex_binding_desc,
+                          std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+                          const DepthState& depth_state,
+                          const SpecializationConstants& specialization);
+
+void write_pipeline_state(std::vector<std::byte>& state,
+                          VkPipelineLayout layout,
+                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                          VkFormat color_attachment_format,
+                          const DepthState& depth_state,
+                          const SpecializationConstants& specialization);
+
 }
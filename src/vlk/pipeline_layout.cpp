@@ -0,0 +1,81 @@
+#include "vlk/pipeline_layout.hpp"
+#include "vlk/device.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace vlk {
+
+PipelineLayout::PipelineLayout(const Device& device,
+                               std::span<const std::vector<VkDescriptorSetLayoutBinding>> set_bindings,
+                               std::span<const VkPushConstantRange> push_constant_ranges) :
+    device_{ device }
+{
+    set_layouts_.reserve(set_bindings.size());
+    for (const auto& bindings : set_bindings) {
+        const VkDescriptorSetLayoutCreateInfo set_layout_create_info = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = static_cast<uint32_t>(bindings.size()),
+            .pBindings = bindings.data()
+        };
+        VkDescriptorSetLayout set_layout;
+        VkResult result = vkCreateDescriptorSetLayout(device, &set_layout_create_info, nullptr, &set_layout);
+        if (result != VK_SUCCESS) {
+            destroy();
+            throw std::runtime_error{ "Failed to create Vulkan descriptor set layout." };
+        }
+        set_layouts_.push_back(set_layout);
+    }
+
+    const VkPipelineLayoutCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = static_cast<uint32_t>(set_layouts_.size()),
+        .pSetLayouts = set_layouts_.data(),
+        .pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size()),
+        .pPushConstantRanges = push_constant_ranges.data()
+    };
+    VkResult result = vkCreatePipelineLayout(device, &create_info, nullptr, &handle_);
+    if (result != VK_SUCCESS) {
+        destroy();
+        throw std::runtime_error{ "Failed to create Vulkan pipeline layout." };
+    }
+}
+
+PipelineLayout::PipelineLayout(PipelineLayout&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) },
+    set_layouts_{ std::move(other.set_layouts_) }
+{
+    other.set_layouts_.clear();
+}
+
+PipelineLayout::~PipelineLayout() {
+    destroy();
+}
+
+PipelineLayout& PipelineLayout::operator=(PipelineLayout&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        device_ = other.device_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+        set_layouts_ = std::move(other.set_layouts_);
+        other.set_layouts_.clear();
+    }
+
+    return *this;
+}
+
+void PipelineLayout::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device_.get(), handle_, nullptr);
+        handle_ = VK_NULL_HANDLE;
+    }
+
+    for (VkDescriptorSetLayout set_layout : set_layouts_) {
+        vkDestroyDescriptorSetLayout(device_.get(), set_layout, nullptr);
+    }
+    set_layouts_.clear();
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <volk/volk.h>
+
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace vlk {
+
+class Device;
+
+// Pipeline layout owning one descriptor set layout per entry of set_bindings.
+class PipelineLayout final :
+    NonCopyable {
+public:
+    PipelineLayout(const Device& device,
+                   std::span<const std::vector<VkDescriptorSetLayoutBinding>> set_bindings,
+                   std::span<const VkPushConstantRange> push_constant_ranges);
+
+    PipelineLayout(PipelineLayout&& other) noexcept;
+
+    ~PipelineLayout();
+
+    std::span<const VkDescriptorSetLayout> get_set_layouts() const noexcept { return set_layouts_; }
+
+    operator VkPipelineLayout() const noexcept { return handle_; }
+
+    PipelineLayout& operator=(PipelineLayout&& other) noexcept;
+private:
+    void destroy() noexcept;
+
+    std::reference_wrapper<const Device> device_;
+    VkPipelineLayout handle_ = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> set_layouts_;
+};
+
+}
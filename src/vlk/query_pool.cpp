@@ -0,0 +1,47 @@
+#include "vlk/query_pool.hpp"
+#include "vlk/device.hpp"
+
+#include <stdexcept>
+
+namespace vlk {
+
+QueryPool::QueryPool(const Device& device, VkQueryType type, uint32_t query_count) :
+    device_{ device }
+{
+    const VkQueryPoolCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = type,
+        .queryCount = query_count
+    };
+    VkResult result = vkCreateQueryPool(device, &create_info, nullptr, &handle_);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to create Vulkan query pool." };
+    }
+}
+
+QueryPool::QueryPool(QueryPool&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ other.handle_ }
+{
+    other.handle_ = VK_NULL_HANDLE;
+}
+
+QueryPool::~QueryPool() {
+    vkDestroyQueryPool(device_, handle_, nullptr);
+}
+
+void QueryPool::get_results(uint32_t first_query, std::span<uint64_t> results) const {
+    VkResult result = vkGetQueryPoolResults(device_,
+                                            handle_,
+                                            first_query,
+                                            static_cast<uint32_t>(results.size()),
+                                            results.size_bytes(),
+                                            results.data(),
+                                            sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to get query pool results." };
+    }
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <volk/volk.h>
+
+#include <cstdint>
+#include <span>
+
+namespace vlk {
+
+class Device;
+
+class QueryPool final :
+    NonCopyable {
+public:
+    QueryPool(const Device& device, VkQueryType type, uint32_t query_count);
+
+    QueryPool(QueryPool&& other) noexcept;
+
+    ~QueryPool();
+
+    // Waits for the queries [first_query, first_query + results.size()) and writes their
+    // 64-bit results.
+    void get_results(uint32_t first_query, std::span<uint64_t> results) const;
+
+    operator VkQueryPool() const noexcept { return handle_; }
+private:
+    const Device& device_;
+    VkQueryPool handle_ = VK_NULL_HANDLE;
+};
+
+}
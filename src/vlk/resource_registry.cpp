@@ -0,0 +1,73 @@
+#include "vlk/resource_registry.hpp"
+#include "utils/hash.hpp"
+
+#include <algorithm>
+
+namespace vlk {
+
+ResourceRegistry::~ResourceRegistry() {
+    pipeline_cache_.clear();
+    pipelines_.clear();
+    image_views_.clear();
+    images_.clear();
+    buffers_.clear();
+}
+
+void ResourceRegistry::collect(uint64_t completed_value) noexcept {
+    buffers_.collect(completed_value);
+    image_views_.collect(completed_value);
+    images_.collect(completed_value);
+    pipelines_.collect(completed_value);
+}
+
+template<typename CreateFunction>
+PipelineHandle ResourceRegistry::get_or_create_cached_pipeline(CreateFunction&& create) {
+    const uint64_t key = hash_bytes(pipeline_state_);
+    auto [first, last] = pipeline_cache_.equal_range(key);
+    auto it = std::find_if(first, last, [&](const auto& entry) { return std::ranges::equal(entry.second.state, pipeline_state_); });
+    if (it == last) {
+        it = pipeline_cache_.emplace(key, CachedPipeline{ .state = pipeline_state_, .handle = {} });
+    }
+
+    // Stale handles of destroyed pipelines fall through and get recreated.
+    PipelineHandle& handle = it->second.handle;
+    if (!pipelines_.contains(handle)) {
+        handle = create();
+    }
+
+    return handle;
+}
+
+PipelineHandle ResourceRegistry::get_or_create_pipeline(const Device& device,
+                                                        VkPipelineLayout layout,
+                                                        std::span<const VkPipelineShaderStageCreateInfo> stages,
+                                                        VkFormat color_attachment_format,
+                                                        const VkVertexInputBindingDescription& vertex_binding_desc,
+                                                        std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+                                                        const DepthState& depth_state,
+                                                        const SpecializationConstants& specialization) {
+    pipeline_state_.clear();
+    write_pipeline_state(pipeline_state_, layout, stages, color_attachment_format, vertex_binding_desc,
+                         vertex_attribute_descs, depth_state, specialization);
+
+    return get_or_create_cached_pipeline([&] {
+        return pipelines_.create(device, layout, stages, color_attachment_format, vertex_binding_desc,
+                                 vertex_attribute_descs, depth_state, specialization);
+    });
+}
+
+PipelineHandle ResourceRegistry::get_or_create_pipeline(const Device& device,
+                                                        VkPipelineLayout layout,
+                                                        std::span<const VkPipelineShaderStageCreateInfo> stages,
+                                                        VkFormat color_attachment_format,
+                                                        const DepthState& depth_state,
+                                                        const SpecializationConstants& specialization) {
+    pipeline_state_.clear();
+    write_pipeline_state(pipeline_state_, layout, stages, color_attachment_format, depth_state, specialization);
+
+    return get_or_create_cached_pipeline([&] {
+        return pipelines_.create(device, layout, stages, color_attachment_format, depth_state, specialization);
+    });
+}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+#include "utils/resource_pool.hpp"
+#include "vlk/buffer.hpp"
+#include "vlk/image.hpp"
+#include "vlk/image_view.hpp"
+#include "vlk/pipeline.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vlk {
+
+// Pools for the GPU resources the renderer creates at runtime. Resources released
+// mid-frame stay alive until collect() is told the GPU finished that frame.
+class ResourceRegistry final :
+    NonCopyable {
+public:
+    ~ResourceRegistry();
+
+    void collect(uint64_t completed_value) noexcept;
+
+    ResourcePool<Buffer>& get_buffers() noexcept { return buffers_; }
+    const ResourcePool<Buffer>& get_buffers() const noexcept { return buffers_; }
+
+    ResourcePool<Image>& get_images() noexcept { return images_; }
+    const ResourcePool<Image>& get_images() const noexcept { return images_; }
+
+    ResourcePool<ImageView>& get_image_views() noexcept { return image_views_; }
+    const ResourcePool<ImageView>& get_image_views() const noexcept { return image_views_; }
+
+    ResourcePool<Pipeline>& get_pipelines() noexcept { return pipelines_; }
+    const ResourcePool<Pipeline>& get_pipelines() const noexcept { return pipelines_; }
+
+    // Returns the pipeline already created from the same state when there is one.
+    PipelineHandle get_or_create_pipeline(const Device& device,
+                                          VkPipelineLayout layout,
+                                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                                          VkFormat color_attachment_format,
+                                          const VkVertexInputBindingDescription& vertex_binding_desc,
+                                          std::span<const VkVertexInputAttributeDescription> vertex_attribute_descs,
+                                          const DepthState& depth_state = {},
+                                          const SpecializationConstants& specialization = {});
+
+    // Mesh shading variant, see the matching Pipeline constructor.
+    PipelineHandle get_or_create_pipeline(const Device& device,
+                                          VkPipelineLayout layout,
+                                          std::span<const VkPipelineShaderStageCreateInfo> stages,
+                                          VkFormat color_attachment_format,
+                                          const DepthState& depth_state = {},
+                                          const SpecializationConstants& specialization = {});
+private:
+    // Keeps the whole state, so colliding hashes are told apart.
+    struct CachedPipeline {
+        std::vector<std::byte> state;
+        PipelineHandle handle;
+    };
+
+    template<typename CreateFunction>
+    PipelineHandle get_or_create_cached_pipeline(CreateFunction&& create);
+
+    ResourcePool<Buffer> buffers_;
+    ResourcePool<Image> images_;
+    ResourcePool<ImageView> image_views_;
+    ResourcePool<Pipeline> pipelines_;
+    // Keyed by the hash of the state.
+    std::unordered_multimap<uint64_t, CachedPipeline> pipeline_cache_;
+    // State of the pipeline being looked up, reused so cache hits don't allocate.
+    std::vector<std::byte> pipeline_state_;
+};
+
+}
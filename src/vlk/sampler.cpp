@@ -0,0 +1,62 @@
+#include "vlk/sampler.hpp"
+#include "vlk/device.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace vlk {
+
+Sampler::Sampler(const Device& device,
+                 VkFilter filter,
+                 VkSamplerAddressMode address_mode,
+                 float max_anisotropy) :
+    device_{ device }
+{
+    const VkSamplerCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = filter,
+        .minFilter = filter,
+        .mipmapMode = filter == VK_FILTER_NEAREST ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR,
+        .addressModeU = address_mode,
+        .addressModeV = address_mode,
+        .addressModeW = address_mode,
+        .anisotropyEnable = max_anisotropy > 1.0f ? VK_TRUE : VK_FALSE,
+        .maxAnisotropy = max_anisotropy,
+        .minLod = 0.0f,
+        .maxLod = VK_LOD_CLAMP_NONE
+    };
+    VkResult result = vkCreateSampler(device, &create_info, nullptr, &handle_);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to create Vulkan sampler." };
+    }
+}
+
+Sampler::Sampler(Sampler&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) }
+{
+}
+
+Sampler::~Sampler() {
+    destroy();
+}
+
+Sampler& Sampler::operator=(Sampler&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        device_ = other.device_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+    }
+
+    return *this;
+}
+
+void Sampler::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vkDestroySampler(device_.get(), handle_, nullptr);
+        handle_ = VK_NULL_HANDLE;
+    }
+}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+
+#include <volk/volk.h>
+
+#include <functional>
+
+namespace vlk {
+
+class Device;
+
+class Sampler final :
+    NonCopyable {
+public:
+    // Anisotropic filtering is enabled when max_anisotropy > 1, the samplerAnisotropy
+    // feature has to be enabled on the device for that.
+    Sampler(const Device& device,
+            VkFilter filter,
+            VkSamplerAddressMode address_mode,
+            float max_anisotropy = 1.0f);
+
+    Sampler(Sampler&& other) noexcept;
+
+    ~Sampler();
+
+    operator VkSampler() const noexcept { return handle_; }
+
+    Sampler& operator=(Sampler&& other) noexcept;
+private:
+    void destroy() noexcept;
+
+    std::reference_wrapper<const Device> device_;
+    VkSampler handle_ = VK_NULL_HANDLE;
+};
+
+}
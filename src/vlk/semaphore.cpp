@@ -17,6 +17,24 @@ Semaphore::Semaphore(const Device& device) :
     }
 }
 
+Semaphore::Semaphore(const Device& device, uint64_t initial_value) :
+    device_{ device }
+{
+    const VkSemaphoreTypeCreateInfo type_create_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = initial_value
+    };
+    const VkSemaphoreCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_create_info
+    };
+    VkResult result = vkCreateSemaphore(device, &create_info, nullptr, &handle_);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error{ "Failed to create Vulkan timeline semaphore." };
+    }
+}
+
 Semaphore::Semaphore(Semaphore &&other) noexcept :
     device_{ other.device_ },
     handle_{ other.handle_ }
@@ -3,6 +3,8 @@
 
 #include <volk/volk.h>
 
+#include <cstdint>
+
 namespace vlk {
 
 class Device;
@@ -11,6 +13,9 @@ class Semaphore final :
     NonCopyable {
 public:
     explicit Semaphore(const Device& device);
+
+    // Timeline semaphore, needs the timelineSemaphore feature.
+    Semaphore(const Device& device, uint64_t initial_value);
     
     Semaphore(Semaphore&& other) noexcept;
 
@@ -0,0 +1,51 @@
+#include "vlk/shader_library.hpp"
+#include "utils/hash.hpp"
+#include "utils/mapped_file.hpp"
+
+#include <algorithm>
+
+namespace vlk {
+
+ShaderLibrary::ShaderLibrary(const Device& device) :
+    device_{ device }
+{
+}
+
+const ShaderModule& ShaderLibrary::load(const char* filename) {
+    if (auto it = file_modules_.find(filename); it != file_modules_.end()) {
+        return *it->second;
+    }
+
+    MappedFile file{ filename };
+    auto bytes = file.get_data();
+    std::span<const uint32_t> code{ reinterpret_cast<const uint32_t*>(bytes.data()), bytes.size() / sizeof(uint32_t) };
+    validate_spirv(code, filename);
+
+    const ShaderModule& module = load(code);
+    file_modules_.emplace(filename, &module);
+
+    return module;
+}
+
+const ShaderModule& ShaderLibrary::load(std::span<const uint32_t> code) {
+    uint64_t hash = hash_bytes(std::as_bytes(code));
+    auto [begin, end] = modules_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (std::ranges::equal(it->second.code, code)) {
+            return it->second.module;
+        }
+    }
+
+    auto it = modules_.emplace(hash, CachedModule{
+        .code = { code.begin(), code.end() },
+        .module = ShaderModule{ device_, code }
+    });
+    return it->second.module;
+}
+
+void ShaderLibrary::clear() noexcept {
+    file_modules_.clear();
+    modules_.clear();
+}
+
+}
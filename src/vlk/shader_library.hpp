@@ -0,0 +1,42 @@
+#pragma once
+#include "utils/non_copyable.hpp"
+#include "vlk/shader_module.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vlk {
+
+class Device;
+
+// Creates each shader module once per unique SPIR-V content and shares it between
+// pipelines. Returned references stay valid until clear() or destruction.
+// Files are cached by name and never read again, call clear() to pick up changes on disk.
+// Not thread safe.
+class ShaderLibrary final :
+    NonCopyable {
+public:
+    explicit ShaderLibrary(const Device& device);
+
+    const ShaderModule& load(const char* filename);
+    const ShaderModule& load(std::span<const uint32_t> code);
+
+    size_t get_module_count() const noexcept { return modules_.size(); }
+
+    void clear() noexcept;
+private:
+    struct CachedModule {
+        std::vector<uint32_t> code;
+        ShaderModule module;
+    };
+
+    const Device& device_;
+    std::unordered_map<std::string, const ShaderModule*> file_modules_;
+    // Keyed by code hash, hits are confirmed against the code.
+    std::unordered_multimap<uint64_t, CachedModule> modules_;
+};
+
+}
@@ -1,52 +1,84 @@
 #include "vlk/shader_module.hpp"
 #include "vlk/device.hpp"
+#include "utils/hash.hpp"
+#include "utils/mapped_file.hpp"
 
 #include <format>
-#include <fstream>
 #include <stdexcept>
+#include <utility>
 
 namespace {
 
-std::vector<uint32_t> read_file(const char* filename) {
-    std::ifstream file{ filename, std::ios::binary | std::ios::ate };
-    if (!file.is_open()) {
-        throw std::runtime_error(std::format("Failed to open file: {}", filename));
-    }
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
 
-    size_t file_size = static_cast<size_t>(file.tellg());
-    std::vector<uint32_t> buffer(file_size / sizeof(uint32_t));
-    file.seekg(0, std::ios::beg);
-    file.read(reinterpret_cast<char*>(buffer.data()), file_size);
-    file.close();
+std::span<const uint32_t> as_spirv(const MappedFile& file, const char* filename) {
+    // Mappings are page aligned, so reinterpreting as words is safe.
+    auto bytes = file.get_data();
+    std::span<const uint32_t> code{ reinterpret_cast<const uint32_t*>(bytes.data()), bytes.size() / sizeof(uint32_t) };
+    vlk::validate_spirv(code, filename);
 
-    return buffer;
+    return code;
 }
 
 }
 
 namespace vlk {
 
+// The temporary mapping lives until the delegated constructor returns.
 ShaderModule::ShaderModule(const Device& device, const char* filename) :
-    device_{ device }
+    ShaderModule{ device, as_spirv(MappedFile{ filename }, filename) }
 {
-    auto shader_code = read_file(filename);
-    if (shader_code[0] != 0x07230203) {
-        throw std::runtime_error(std::format("Not a valid SPIR-V - {}", filename));
-    }
+}
 
+ShaderModule::ShaderModule(const Device& device, std::span<const uint32_t> code) :
+    device_{ device },
+    hash_{ hash_bytes(std::as_bytes(code)) }
+{
     const VkShaderModuleCreateInfo create_info = {
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = shader_code.size() * sizeof(uint32_t),
-        .pCode = shader_code.data()
+        .codeSize = code.size_bytes(),
+        .pCode = code.data()
     };
     VkResult result = vkCreateShaderModule(device, &create_info, nullptr, &handle_);
     if (result != VK_SUCCESS) {
-        throw std::runtime_error(std::format("Failed to create Vulkan shader module from: {}", filename));
+        throw std::runtime_error{ "Failed to create Vulkan shader module." };
     }
 }
 
+ShaderModule::ShaderModule(ShaderModule&& other) noexcept :
+    device_{ other.device_ },
+    handle_{ std::exchange(other.handle_, VK_NULL_HANDLE) },
+    hash_{ std::exchange(other.hash_, 0) }
+{
+}
+
 ShaderModule::~ShaderModule() {
-    vkDestroyShaderModule(device_, handle_, nullptr);
+    destroy();
+}
+
+ShaderModule& ShaderModule::operator=(ShaderModule&& other) noexcept {
+    if (this != &other) {
+        destroy();
+
+        device_ = other.device_;
+        handle_ = std::exchange(other.handle_, VK_NULL_HANDLE);
+        hash_ = std::exchange(other.hash_, 0);
+    }
+
+    return *this;
+}
+
+void ShaderModule::destroy() noexcept {
+    if (handle_ != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device_.get(), handle_, nullptr);
+        handle_ = VK_NULL_HANDLE;
+    }
+}
+
+void validate_spirv(std::span<const uint32_t> code, const char* name) {
+    if (code.empty() || code[0] != SPIRV_MAGIC) {
+        throw std::runtime_error(std::format("Not a valid SPIR-V - {}", name));
+    }
 }
 
 }
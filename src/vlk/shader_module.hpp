@@ -3,6 +3,10 @@
 
 #include <volk/volk.h>
 
+#include <cstdint>
+#include <functional>
+#include <span>
+
 namespace vlk {
 
 class Device;
@@ -12,12 +16,27 @@ class ShaderModule final :
 public:
     ShaderModule(const Device& device, const char* filename);
 
+    ShaderModule(const Device& device, std::span<const uint32_t> code);
+
+    ShaderModule(ShaderModule&& other) noexcept;
+
     ~ShaderModule();
 
+    // Hash of the SPIR-V words the module was created from.
+    uint64_t get_hash() const noexcept { return hash_; }
+
     operator VkShaderModule() const noexcept { return handle_; }
+
+    ShaderModule& operator=(ShaderModule&& other) noexcept;
 private:
-    const Device& device_;
+    void destroy() noexcept;
+
+    std::reference_wrapper<const Device> device_;
     VkShaderModule handle_ = VK_NULL_HANDLE;
+    uint64_t hash_ = 0;
 };
 
+// Throws when code doesn't start with the SPIR-V magic number.
+void validate_spirv(std::span<const uint32_t> code, const char* name);
+
 }
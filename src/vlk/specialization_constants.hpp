@@ -0,0 +1,78 @@
+#pragma once
+#include "utils/inline_vector.hpp"
+
+#include <volk/volk.h>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace vlk {
+
+// Values for shader constants declared with [vk::constant_id(N)]. Booleans are
+// stored as VkBool32, everything else has to be a 32-bit scalar. Up to MAX_CONSTANTS
+// are stored inline.
+class SpecializationConstants {
+public:
+    static constexpr size_t MAX_CONSTANTS = 16;
+
+    template<typename T>
+        requires std::same_as<T, bool> || ((std::integral<T> || std::floating_point<T>) && sizeof(T) == 4)
+    SpecializationConstants& set(uint32_t constant_id, T value) {
+        uint32_t bits;
+        if constexpr (std::same_as<T, bool>) {
+            bits = value ? VK_TRUE : VK_FALSE;
+        }
+        else {
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+
+        auto it = std::ranges::find(entries_, constant_id, &VkSpecializationMapEntry::constantID);
+        if (it != entries_.end()) {
+            std::memcpy(data_.data() + it->offset, &bits, sizeof(bits));
+            return *this;
+        }
+
+        entries_.push_back({
+            .constantID = constant_id,
+            .offset = static_cast<uint32_t>(data_.size()),
+            .size = sizeof(bits)
+        });
+        data_.resize(data_.size() + sizeof(bits));
+        std::memcpy(data_.data() + entries_.back().offset, &bits, sizeof(bits));
+        return *this;
+    }
+
+    bool is_empty() const noexcept { return entries_.empty(); }
+
+    // Points into this object, which has to outlive the pipeline creation.
+    VkSpecializationInfo get_info() const noexcept {
+        return {
+            .mapEntryCount = static_cast<uint32_t>(entries_.size()),
+            .pMapEntries = entries_.data(),
+            .dataSize = data_.size(),
+            .pData = data_.data()
+        };
+    }
+
+    // Appends the constants in ID order, so the result is independent of the order they
+    // were set in.
+    void write_state(std::vector<std::byte>& state) const {
+        auto sorted_entries = entries_;
+        std::ranges::sort(sorted_entries, {}, &VkSpecializationMapEntry::constantID);
+        for (const auto& entry : sorted_entries) {
+            const auto id_bytes = std::as_bytes(std::span{ &entry.constantID, 1 });
+            state.insert(state.end(), id_bytes.begin(), id_bytes.end());
+            state.insert(state.end(), data_.begin() + entry.offset, data_.begin() + entry.offset + entry.size);
+        }
+    }
+private:
+    InlineVector<VkSpecializationMapEntry, MAX_CONSTANTS> entries_;
+    InlineVector<std::byte, MAX_CONSTANTS * sizeof(uint32_t)> data_;
+};
+
+}
@@ -0,0 +1,101 @@
+#include "vlk/submit_batch.hpp"
+#include "vlk/fence.hpp"
+#include "vlk/queue.hpp"
+
+#include <stdexcept>
+
+namespace vlk {
+
+SubmitBatch& SubmitBatch::add_command_buffer(VkCommandBuffer cmd_buffer) {
+    if (cmd_buffer_count_ == MAX_COMMAND_BUFFERS) {
+        throw std::runtime_error{ "Too many command buffers in a submit batch." };
+    }
+
+    cmd_buffers_[cmd_buffer_count_++] = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = cmd_buffer
+    };
+    ++get_current().cmd_buffer_count;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::add_wait(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value) {
+    if (wait_count_ == MAX_SEMAPHORES) {
+        throw std::runtime_error{ "Too many wait semaphores in a submit batch." };
+    }
+
+    waits_[wait_count_++] = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = semaphore,
+        .value = value,
+        .stageMask = stage
+    };
+    ++get_current().wait_count;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::add_signal(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value) {
+    if (signal_count_ == MAX_SEMAPHORES) {
+        throw std::runtime_error{ "Too many signal semaphores in a submit batch." };
+    }
+
+    signals_[signal_count_++] = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = semaphore,
+        .value = value,
+        .stageMask = stage
+    };
+    ++get_current().signal_count;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::next_submission() {
+    if (is_submission_empty(get_current())) {
+        return *this;
+    }
+    if (submission_count_ == MAX_SUBMISSIONS) {
+        throw std::runtime_error{ "Too many submissions in a submit batch." };
+    }
+
+    submissions_[submission_count_++] = {
+        .first_wait = wait_count_,
+        .first_cmd_buffer = cmd_buffer_count_,
+        .first_signal = signal_count_
+    };
+    return *this;
+}
+
+void SubmitBatch::clear() noexcept {
+    submissions_[0] = {};
+    submission_count_ = 1;
+    cmd_buffer_count_ = 0;
+    wait_count_ = 0;
+    signal_count_ = 0;
+}
+
+void SubmitBatch::flush(const Queue& queue, const Fence* fence) {
+    // A trailing next_submission() leaves an empty one behind, which is not sent.
+    const uint32_t submit_count = submission_count_ > 1 && is_submission_empty(get_current()) ? submission_count_ - 1 : submission_count_;
+
+    std::array<VkSubmitInfo2, MAX_SUBMISSIONS> submit_infos;
+    for (uint32_t i = 0; i < submit_count; ++i) {
+        const Submission& submission = submissions_[i];
+        submit_infos[i] = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .waitSemaphoreInfoCount = submission.wait_count,
+            .pWaitSemaphoreInfos = waits_.data() + submission.first_wait,
+            .commandBufferInfoCount = submission.cmd_buffer_count,
+            .pCommandBufferInfos = cmd_buffers_.data() + submission.first_cmd_buffer,
+            .signalSemaphoreInfoCount = submission.signal_count,
+            .pSignalSemaphoreInfos = signals_.data() + submission.first_signal
+        };
+    }
+
+    VkResult result = vkQueueSubmit2(queue, submit_count, submit_infos.data(), fence != nullptr ? *fence : VK_NULL_HANDLE);
+    clear();
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit a batch to a queue.");
+    }
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <volk/volk.h>
+
+#include <array>
+#include <cstdint>
+
+namespace vlk {
+
+class Fence;
+class Queue;
+
+// Work for one vkQueueSubmit2 call. Command buffers and semaphores go to the current
+// submission, next_submission() starts another one in the same call, e.g. graphics work
+// waiting on the transfer before it. Capacity is fixed, so building a batch never allocates.
+class SubmitBatch final {
+public:
+    static constexpr uint32_t MAX_SUBMISSIONS = 4;
+    static constexpr uint32_t MAX_COMMAND_BUFFERS = 16;
+    static constexpr uint32_t MAX_SEMAPHORES = 8;
+
+    SubmitBatch& add_command_buffer(VkCommandBuffer cmd_buffer);
+
+    // Work in the submission at stage waits for the semaphore. value is only read for
+    // timeline semaphores.
+    SubmitBatch& add_wait(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value = 0);
+
+    // The semaphore is signaled once the submission's work up to stage is done.
+    SubmitBatch& add_signal(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value = 0);
+
+    SubmitBatch& next_submission();
+
+    bool is_empty() const noexcept { return submission_count_ == 1 && is_submission_empty(submissions_[0]); }
+
+    void clear() noexcept;
+
+    // Submits everything in one call, then clears the batch.
+    void flush(const Queue& queue, const Fence* fence = nullptr);
+private:
+    struct Submission {
+        uint32_t first_wait;
+        uint32_t wait_count;
+        uint32_t first_cmd_buffer;
+        uint32_t cmd_buffer_count;
+        uint32_t first_signal;
+        uint32_t signal_count;
+    };
+
+    static bool is_submission_empty(const Submission& submission) noexcept {
+        return submission.wait_count == 0 && submission.cmd_buffer_count == 0 && submission.signal_count == 0;
+    }
+
+    Submission& get_current() noexcept { return submissions_[submission_count_ - 1]; }
+
+    std::array<Submission, MAX_SUBMISSIONS> submissions_ = {};
+    std::array<VkCommandBufferSubmitInfo, MAX_COMMAND_BUFFERS> cmd_buffers_;
+    std::array<VkSemaphoreSubmitInfo, MAX_SEMAPHORES> waits_;
+    std::array<VkSemaphoreSubmitInfo, MAX_SEMAPHORES> signals_;
+    uint32_t submission_count_ = 1;
+    uint32_t cmd_buffer_count_ = 0;
+    uint32_t wait_count_ = 0;
+    uint32_t signal_count_ = 0;
+};
+
+}
@@ -4,12 +4,21 @@
 #include "vlk/command_pool.hpp"
 #include "vlk/device.hpp"
 #include "vlk/fence.hpp"
+#include "vlk/image.hpp"
+#include "vlk/image_view.hpp"
 #include "vlk/instance.hpp"
 #include "vlk/memory_allocator.hpp"
 #include "vlk/physical_device.hpp"
 #include "vlk/pipeline.hpp"
+#include "vlk/pipeline_layout.hpp"
+#include "vlk/query_pool.hpp"
 #include "vlk/queue.hpp"
+#include "vlk/resource_registry.hpp"
+#include "vlk/sampler.hpp"
 #include "vlk/semaphore.hpp"
+#include "vlk/shader_library.hpp"
 #include "vlk/shader_module.hpp"
+#include "vlk/specialization_constants.hpp"
+#include "vlk/submit_batch.hpp"
 #include "vlk/surface.hpp"
 #include "vlk/swapchain.hpp"
@@ -0,0 +1,80 @@
+#include "headless_device.hpp"
+
+#include <optional>
+#include <span>
+
+namespace tools {
+
+VkApplicationInfo get_headless_app_info(const char* application_name) noexcept {
+    return {
+        .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+        .pApplicationName = application_name,
+        .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+        .pEngineName = "No Engine",
+        .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+        .apiVersion = VK_API_VERSION_1_3
+    };
+}
+
+vlk::Device create_headless_device(const vlk::Instance& instance,
+                                   uint32_t& queue_family_index,
+                                   std::string& device_name) {
+    std::optional<vlk::PhysicalDevice> chosen_device;
+    for (auto& physical_device : instance.get_physical_devices()) {
+        auto props = physical_device.get_properties();
+        if (props.apiVersion < VK_API_VERSION_1_3) {
+            continue;
+        }
+
+        auto queue_family_props = physical_device.get_queue_family_properties();
+        for (uint32_t i = 0; i < queue_family_props.size(); ++i) {
+            if (queue_family_props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                if (!chosen_device || props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+                    chosen_device = physical_device;
+                    queue_family_index = i;
+                    device_name = props.deviceName;
+                }
+                break;
+            }
+        }
+
+        if (chosen_device && props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+            break;
+        }
+    }
+
+    if (!chosen_device) {
+        throw NoDeviceError("Failed to pick Vulkan physical device.");
+    }
+
+    float queue_priority = 1.0f;
+    VkDeviceQueueCreateInfo queue_create_info = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueFamilyIndex = queue_family_index,
+        .queueCount = 1,
+        .pQueuePriorities = &queue_priority
+    };
+
+    VkPhysicalDeviceVulkan13Features vlk13_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .synchronization2 = VK_TRUE,
+        .dynamicRendering = VK_TRUE
+    };
+
+    VkPhysicalDeviceVulkan12Features vlk12_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &vlk13_features,
+        .timelineSemaphore = VK_TRUE,
+        .bufferDeviceAddress = VK_TRUE
+    };
+
+    VkPhysicalDeviceVulkan11Features vlk11_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+        .pNext = &vlk12_features,
+        .shaderDrawParameters = VK_TRUE
+    };
+
+    return { *chosen_device, std::span{ &queue_create_info, 1 }, {}, &vlk11_features };
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "vlk/vlk.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Device setup shared by the tools that render or benchmark without a window.
+
+namespace tools {
+
+// Thrown when no device is suitable, so tools can tell a machine without Vulkan apart
+// from a failure.
+struct NoDeviceError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+VkApplicationInfo get_headless_app_info(const char* application_name) noexcept;
+
+// Any Vulkan 1.3 device with a graphics queue, discrete GPUs first, with the features the
+// application enables plus timeline semaphores. Fills the queue family to get the queue
+// from and the name of the picked device. Throws NoDeviceError when nothing qualifies.
+vlk::Device create_headless_device(const vlk::Instance& instance,
+                                   uint32_t& queue_family_index,
+                                   std::string& device_name);
+
+}
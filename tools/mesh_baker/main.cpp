@@ -0,0 +1,88 @@
+#include "mesh_simplifier.hpp"
+#include "mesh_writer.hpp"
+#include "meshlet_builder.hpp"
+#include "obj_loader.hpp"
+#include "assets/mesh_optimizer.hpp"
+
+#include <iostream>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void optimize_mesh(assets::MeshData& mesh) {
+    auto vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+    auto before = assets::analyze_vertex_cache(mesh.indices, vertex_count);
+
+    // LODs are drawn on their own, so each range is ordered independently.
+    for (const auto& lod : mesh.lods) {
+        auto lod_indices = std::span{ mesh.indices }.subspan(lod.index_offset, lod.index_count);
+        assets::optimize_vertex_cache(lod_indices, vertex_count);
+        assets::optimize_overdraw(lod_indices, mesh.vertices);
+    }
+
+    std::vector<uint32_t> remap(vertex_count);
+    vertex_count = assets::optimize_vertex_fetch(mesh.indices, remap);
+    std::vector<assets::MeshVertex> vertices(vertex_count);
+    assets::remap_vertices(std::as_writable_bytes(std::span{ vertices }),
+                           std::as_bytes(std::span{ mesh.vertices }),
+                           sizeof(assets::MeshVertex),
+                           remap);
+    mesh.vertices = std::move(vertices);
+
+    auto after = assets::analyze_vertex_cache(mesh.indices, vertex_count);
+    std::println("ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", before.acmr, after.acmr, before.atvr, after.atvr);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    auto vertex_format = assets::VertexFormat::Float32;
+    bool optimize = true;
+    bool build_lods = true;
+    for (; argc > 3 && std::string_view{ argv[1] }.starts_with("--"); ++argv, --argc) {
+        std::string_view option = argv[1];
+        if (option == "--quantize") {
+            vertex_format = assets::VertexFormat::Quantized;
+        }
+        else if (option == "--no-optimize") {
+            optimize = false;
+        }
+        else if (option == "--no-lods") {
+            build_lods = false;
+        }
+        else {
+            break;
+        }
+    }
+
+    if (argc != 3) {
+        std::println(std::cerr, "Usage: mesh_baker [--quantize] [--no-optimize] [--no-lods] <input.obj> <output.vmesh>");
+        return 1;
+    }
+
+    try {
+        auto mesh = mesh_baker::load_obj(argv[1]);
+        mesh_baker::build_lod_chain(mesh, build_lods ? mesh_baker::MAX_LOD_COUNT : 1);
+        if (optimize) {
+            optimize_mesh(mesh);
+        }
+        mesh_baker::build_meshlets(mesh);
+        mesh_baker::write_mesh_file(argv[2], mesh, vertex_format, optimize ? assets::MESH_FLAG_OPTIMIZED : 0);
+        std::println("Baked {}: {} vertices, {} meshlets.", argv[2], mesh.vertices.size(), mesh.meshlets.size());
+        for (size_t i = 0; i < mesh.lods.size(); ++i) {
+            std::println("  LOD {}: {} triangles, {} meshlets, error {:.6f}",
+                         i, mesh.lods[i].index_count / 3, mesh.lods[i].meshlet_count, mesh.lods[i].error);
+        }
+    }
+    catch (const std::exception& e) {
+        std::println(std::cerr, "{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
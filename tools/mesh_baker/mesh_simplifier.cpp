@@ -0,0 +1,347 @@
+#include "mesh_simplifier.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+
+namespace {
+
+// Each LOD aims for this fraction of the previous one's triangles.
+constexpr float LOD_REDUCTION = 0.5f;
+
+// The chain ends once a LOD is this small or simplification stops paying off.
+constexpr size_t MIN_LOD_TRIANGLES = 64;
+constexpr float MIN_LOD_SAVINGS = 0.2f;
+
+// Collapses may turn a triangle's normal by at most ~75 degrees, steeper turns
+// fold thin triangles over their neighbours.
+constexpr float MIN_NORMAL_DOT = 0.25f;
+
+// Border planes outweigh surface planes so open edges only move along themselves.
+constexpr double BORDER_WEIGHT = 10.0;
+
+enum class VertexKind : uint8_t {
+    Interior,
+    Border,
+    Locked
+};
+
+// Sum of squared distances to a set of planes, as the symmetric matrix
+// [a00 a01 a02 a03; . a11 a12 a13; . . a22 a23; . . . a33], weighted by plane area.
+struct Quadric {
+    double a00, a01, a02, a03;
+    double a11, a12, a13;
+    double a22, a23;
+    double a33;
+    double weight;
+};
+
+Quadric get_plane_quadric(const glm::vec3& normal, const glm::vec3& point, double weight) {
+    const double x = normal.x;
+    const double y = normal.y;
+    const double z = normal.z;
+    const double d = -(x * point.x + y * point.y + z * point.z);
+    return {
+        x * x * weight, x * y * weight, x * z * weight, x * d * weight,
+        y * y * weight, y * z * weight, y * d * weight,
+        z * z * weight, z * d * weight,
+        d * d * weight,
+        weight
+    };
+}
+
+void add_quadric(Quadric& dst, const Quadric& src) {
+    dst.a00 += src.a00;
+    dst.a01 += src.a01;
+    dst.a02 += src.a02;
+    dst.a03 += src.a03;
+    dst.a11 += src.a11;
+    dst.a12 += src.a12;
+    dst.a13 += src.a13;
+    dst.a22 += src.a22;
+    dst.a23 += src.a23;
+    dst.a33 += src.a33;
+    dst.weight += src.weight;
+}
+
+// Weighted mean squared distance of point to the planes of q and r.
+double get_collapse_error(const Quadric& q, const Quadric& r, const glm::vec3& point) {
+    Quadric sum = q;
+    add_quadric(sum, r);
+    const double x = point.x;
+    const double y = point.y;
+    const double z = point.z;
+    const double error = x * x * sum.a00 + y * y * sum.a11 + z * z * sum.a22 + sum.a33 +
+                         2.0 * (x * y * sum.a01 + x * z * sum.a02 + y * z * sum.a12 +
+                                x * sum.a03 + y * sum.a13 + z * sum.a23);
+    return sum.weight > 0.0 ? std::max(error / sum.weight, 0.0) : 0.0;
+}
+
+uint64_t get_edge_key(uint32_t from, uint32_t to) {
+    return (uint64_t{ from } << 32) | to;
+}
+
+// Maps every vertex to the first vertex with the same position.
+std::vector<uint32_t> get_position_remap(std::span<const assets::MeshVertex> vertices) {
+    std::vector<uint32_t> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0u);
+    auto get_position = [&](uint32_t v) {
+        const glm::vec3& p = vertices[v].position;
+        return std::tie(p.x, p.y, p.z);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return get_position(lhs) < get_position(rhs);
+    });
+
+    std::vector<uint32_t> remap(vertices.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        bool same_as_previous = i > 0 && get_position(order[i]) == get_position(order[i - 1]);
+        remap[order[i]] = same_as_previous ? remap[order[i - 1]] : order[i];
+    }
+
+    return remap;
+}
+
+void remove_degenerate_triangles(std::vector<uint32_t>& indices) {
+    size_t write = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        uint32_t a = indices[i];
+        uint32_t b = indices[i + 1];
+        uint32_t c = indices[i + 2];
+        if (a != b && b != c && c != a) {
+            indices[write++] = a;
+            indices[write++] = b;
+            indices[write++] = c;
+        }
+    }
+    indices.resize(write);
+}
+
+}
+
+namespace mesh_baker {
+
+SimplifiedMesh simplify_mesh(std::span<const uint32_t> indices,
+                             std::span<const assets::MeshVertex> vertices,
+                             size_t target_index_count) {
+    const auto vertex_count = static_cast<uint32_t>(vertices.size());
+    auto position_remap = get_position_remap(vertices);
+
+    SimplifiedMesh result = { .indices = {}, .error = 0.0f };
+    result.indices.reserve(indices.size());
+    for (uint32_t index : indices) {
+        result.indices.push_back(position_remap[index]);
+    }
+    remove_degenerate_triangles(result.indices);
+    auto& output = result.indices;
+
+    // Directed edges without a twin are borders; edges used twice in one direction
+    // belong to non-manifold geometry, whose vertices stay put.
+    std::vector<uint64_t> edges;
+    edges.reserve(output.size());
+    for (size_t i = 0; i < output.size(); i += 3) {
+        for (size_t k = 0; k < 3; ++k) {
+            edges.push_back(get_edge_key(output[i + k], output[i + (k + 1) % 3]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    auto is_border_edge = [&](uint32_t from, uint32_t to) {
+        return !std::binary_search(edges.begin(), edges.end(), get_edge_key(to, from));
+    };
+
+    std::vector<VertexKind> kinds(vertex_count, VertexKind::Interior);
+    std::vector<uint32_t> border_edge_counts(vertex_count, 0);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        auto from = static_cast<uint32_t>(edges[i] >> 32);
+        auto to = static_cast<uint32_t>(edges[i]);
+        if (i > 0 && edges[i] == edges[i - 1]) {
+            kinds[from] = VertexKind::Locked;
+            kinds[to] = VertexKind::Locked;
+        }
+        if (is_border_edge(from, to)) {
+            ++border_edge_counts[from];
+        }
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+        if (kinds[v] == VertexKind::Interior && border_edge_counts[v] > 0) {
+            kinds[v] = border_edge_counts[v] == 1 ? VertexKind::Border : VertexKind::Locked;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertex_count, Quadric{});
+    for (size_t i = 0; i < output.size(); i += 3) {
+        const glm::vec3& p0 = vertices[output[i]].position;
+        const glm::vec3& p1 = vertices[output[i + 1]].position;
+        const glm::vec3& p2 = vertices[output[i + 2]].position;
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float area = glm::length(normal);
+        if (area == 0.0f) {
+            continue;
+        }
+        normal /= area;
+
+        auto quadric = get_plane_quadric(normal, p0, area);
+        for (size_t k = 0; k < 3; ++k) {
+            add_quadric(quadrics[output[i + k]], quadric);
+        }
+
+        for (size_t k = 0; k < 3; ++k) {
+            uint32_t from = output[i + k];
+            uint32_t to = output[i + (k + 1) % 3];
+            if (!is_border_edge(from, to)) {
+                continue;
+            }
+            glm::vec3 edge = vertices[to].position - vertices[from].position;
+            float length = glm::length(edge);
+            if (length == 0.0f) {
+                continue;
+            }
+            auto border_quadric = get_plane_quadric(glm::normalize(glm::cross(edge, normal)),
+                                                    vertices[from].position,
+                                                    length * length * BORDER_WEIGHT);
+            add_quadric(quadrics[from], border_quadric);
+            add_quadric(quadrics[to], border_quadric);
+        }
+    }
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double error;
+    };
+
+    std::vector<uint32_t> adjacency_offsets(vertex_count + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<bool> locked(vertex_count);
+    double max_error = 0.0;
+
+    // Every pass collapses the cheapest edges whose neighbourhoods don't overlap, so the
+    // adjacency built at its start stays valid throughout.
+    while (output.size() > target_index_count) {
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+        for (uint32_t index : output) {
+            ++adjacency_offsets[index + 1];
+        }
+        std::inclusive_scan(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+        adjacency.resize(output.size());
+        {
+            std::vector<uint32_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (uint32_t i = 0; i < output.size(); ++i) {
+                adjacency[cursors[output[i]]++] = i / 3;
+            }
+        }
+
+        collapses.clear();
+        for (size_t i = 0; i < output.size(); i += 3) {
+            for (size_t k = 0; k < 3; ++k) {
+                uint32_t a = output[i + k];
+                uint32_t b = output[i + (k + 1) % 3];
+                for (auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } }) {
+                    // Border vertices may only slide along their border.
+                    if (kinds[from] == VertexKind::Locked ||
+                        (kinds[from] == VertexKind::Border &&
+                         (kinds[to] == VertexKind::Interior || !(is_border_edge(from, to) || is_border_edge(to, from))))) {
+                        continue;
+                    }
+                    collapses.push_back({ from, to, get_collapse_error(quadrics[from], quadrics[to], vertices[to].position) });
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+            return lhs.error < rhs.error;
+        });
+
+        std::fill(locked.begin(), locked.end(), false);
+        size_t triangle_count = output.size() / 3;
+        const size_t target_triangle_count = target_index_count / 3;
+        size_t collapse_count = 0;
+        for (const auto& collapse : collapses) {
+            if (triangle_count <= target_triangle_count) {
+                break;
+            }
+            if (locked[collapse.from] || locked[collapse.to]) {
+                continue;
+            }
+
+            // Reject collapses that would flip, fold or flatten a triangle around from.
+            const glm::vec3& from_position = vertices[collapse.from].position;
+            const glm::vec3& to_position = vertices[collapse.to].position;
+            auto begin = adjacency.begin() + adjacency_offsets[collapse.from];
+            auto end = adjacency.begin() + adjacency_offsets[collapse.from + 1];
+            uint32_t removed_triangles = 0;
+            bool flips = false;
+            for (auto it = begin; it != end && !flips; ++it) {
+                const uint32_t* triangle = &output[*it * 3];
+                if (std::find(triangle, triangle + 3, collapse.to) != triangle + 3) {
+                    ++removed_triangles;
+                    continue;
+                }
+                uint32_t corner = static_cast<uint32_t>(std::find(triangle, triangle + 3, collapse.from) - triangle);
+                const glm::vec3& p1 = vertices[triangle[(corner + 1) % 3]].position;
+                const glm::vec3& p2 = vertices[triangle[(corner + 2) % 3]].position;
+                glm::vec3 old_normal = glm::cross(p1 - from_position, p2 - from_position);
+                glm::vec3 new_normal = glm::cross(p1 - to_position, p2 - to_position);
+                flips = glm::dot(old_normal, new_normal) <= MIN_NORMAL_DOT * glm::length(old_normal) * glm::length(new_normal);
+            }
+            if (flips) {
+                continue;
+            }
+
+            for (auto it = begin; it != end; ++it) {
+                uint32_t* triangle = &output[*it * 3];
+                for (uint32_t k = 0; k < 3; ++k) {
+                    locked[triangle[k]] = true;
+                    if (triangle[k] == collapse.from) {
+                        triangle[k] = collapse.to;
+                    }
+                }
+            }
+            add_quadric(quadrics[collapse.to], quadrics[collapse.from]);
+            max_error = std::max(max_error, collapse.error);
+            triangle_count -= removed_triangles;
+            ++collapse_count;
+        }
+
+        remove_degenerate_triangles(output);
+        if (collapse_count == 0) {
+            break;
+        }
+    }
+
+    result.error = static_cast<float>(std::sqrt(max_error));
+    return result;
+}
+
+void build_lod_chain(assets::MeshData& mesh, size_t max_lod_count) {
+    const auto full_index_count = static_cast<uint32_t>(mesh.indices.size());
+    mesh.lods = { { .index_offset = 0, .index_count = full_index_count, .meshlet_offset = 0, .meshlet_count = 0, .error = 0.0f, .reserved = {} } };
+
+    // Each LOD is simplified from the previous one, so errors add up along the chain.
+    std::vector<uint32_t> lod_indices = mesh.indices;
+    float error = 0.0f;
+    while (mesh.lods.size() < max_lod_count && lod_indices.size() / 3 >= MIN_LOD_TRIANGLES * 2) {
+        size_t target_index_count = static_cast<size_t>(lod_indices.size() / 3 * LOD_REDUCTION) * 3;
+        auto simplified = simplify_mesh(lod_indices, mesh.vertices, target_index_count);
+        if (simplified.indices.size() > lod_indices.size() * (1.0f - MIN_LOD_SAVINGS)) {
+            break;
+        }
+
+        error += simplified.error;
+        mesh.lods.push_back({
+            .index_offset = static_cast<uint32_t>(mesh.indices.size()),
+            .index_count = static_cast<uint32_t>(simplified.indices.size()),
+            .meshlet_offset = 0,
+            .meshlet_count = 0,
+            .error = error,
+            .reserved = {}
+        });
+        mesh.indices.insert(mesh.indices.end(), simplified.indices.begin(), simplified.indices.end());
+        lod_indices = std::move(simplified.indices);
+    }
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "assets/mesh_data.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mesh_baker {
+
+inline constexpr size_t MAX_LOD_COUNT = 8;
+
+struct SimplifiedMesh {
+    std::vector<uint32_t> indices;
+    // Largest distance the surface moved by, in mesh units.
+    float error;
+};
+
+// Collapses edges by quadric error (Garland & Heckbert) until at most target_index_count
+// indices remain or no edge can be collapsed without flipping a triangle or tearing a
+// border open. Collapses only move a vertex onto a neighbour, so the result indexes
+// the same vertices. Vertices sharing a position are welded, which lets attribute
+// seams collapse as one but gives them the attributes of one side.
+SimplifiedMesh simplify_mesh(std::span<const uint32_t> indices,
+                             std::span<const assets::MeshVertex> vertices,
+                             size_t target_index_count);
+
+// Simplifies LOD 0 (the whole index buffer) into a chain of up to max_lod_count LODs, each
+// with about half the triangles of the previous one, appends their indices and fills mesh.lods.
+void build_lod_chain(assets::MeshData& mesh, size_t max_lod_count = MAX_LOD_COUNT);
+
+}
@@ -0,0 +1,116 @@
+#include "mesh_writer.hpp"
+#include "assets/mesh_optimizer.hpp"
+#include "assets/vertex_quantization.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <format>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+class BlobWriter {
+public:
+    explicit BlobWriter(const char* filename) :
+        file_{ filename, std::ios::binary }
+    {
+        if (!file_.is_open()) {
+            throw std::runtime_error(std::format("Failed to open file for writing: {}", filename));
+        }
+
+        offset_ = sizeof(assets::MeshFileHeader);
+        file_.seekp(static_cast<std::streamoff>(offset_));
+    }
+
+    template<typename T>
+    assets::MeshBlob write(std::span<const T> data) {
+        pad_to(assets::align_mesh_blob(offset_));
+
+        assets::MeshBlob blob = { offset_, data.size_bytes() };
+        file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size_bytes()));
+        offset_ += data.size_bytes();
+        return blob;
+    }
+
+    void finish(const assets::MeshFileHeader& header) {
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!file_) {
+            throw std::runtime_error{ "Failed to write mesh file." };
+        }
+    }
+private:
+    void pad_to(uint64_t offset) {
+        static constexpr char zeros[assets::MESH_BLOB_ALIGNMENT] = {};
+        file_.write(zeros, static_cast<std::streamsize>(offset - offset_));
+        offset_ = offset;
+    }
+
+    std::ofstream file_;
+    uint64_t offset_ = 0;
+};
+
+}
+
+namespace mesh_baker {
+
+void write_mesh_file(const char* filename, const assets::MeshData& mesh, assets::VertexFormat vertex_format, uint32_t flags) {
+    assets::MeshFileHeader header = {
+        .magic = assets::MESH_FILE_MAGIC,
+        .version = assets::MESH_FILE_VERSION,
+        .vertex_format = vertex_format,
+        .index_type = assets::get_index_type(static_cast<uint32_t>(mesh.vertices.size())),
+        .vertex_stride = static_cast<uint32_t>(vertex_format == assets::VertexFormat::Quantized ?
+            sizeof(assets::QuantizedMeshVertex) : sizeof(assets::MeshVertex)),
+        .vertex_count = static_cast<uint32_t>(mesh.vertices.size()),
+        .index_count = static_cast<uint32_t>(mesh.indices.size()),
+        .flags = flags,
+        .bounds_min = glm::vec3{ std::numeric_limits<float>::max() },
+        .bounds_max = glm::vec3{ std::numeric_limits<float>::lowest() }
+    };
+    for (const auto& vertex : mesh.vertices) {
+        header.bounds_min = glm::min(header.bounds_min, vertex.position);
+        header.bounds_max = glm::max(header.bounds_max, vertex.position);
+    }
+
+    // Meshes without a LOD chain are a single LOD covering everything.
+    std::vector<assets::MeshLod> lods = mesh.lods;
+    if (lods.empty()) {
+        lods.push_back({
+            .index_offset = 0,
+            .index_count = header.index_count,
+            .meshlet_offset = 0,
+            .meshlet_count = static_cast<uint32_t>(mesh.meshlets.size()),
+            .error = 0.0f,
+            .reserved = {}
+        });
+    }
+    header.lod_count = static_cast<uint32_t>(lods.size());
+
+    BlobWriter writer{ filename };
+    if (vertex_format == assets::VertexFormat::Quantized) {
+        auto bounds = assets::get_quantization_bounds(header.bounds_min, header.bounds_max);
+        std::vector<assets::QuantizedMeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+        for (const auto& vertex : mesh.vertices) {
+            vertices.push_back(assets::quantize_vertex(vertex, bounds));
+        }
+        header.vertices = writer.write(std::span<const assets::QuantizedMeshVertex>{ vertices });
+    }
+    else {
+        header.vertices = writer.write(std::span{ mesh.vertices });
+    }
+    auto indices = assets::pack_indices(mesh.indices, header.index_type);
+    header.indices = writer.write(std::span<const std::byte>{ indices });
+    header.lods = writer.write(std::span<const assets::MeshLod>{ lods });
+    header.meshlet_count = static_cast<uint32_t>(mesh.meshlets.size());
+    header.meshlets = writer.write(std::span{ mesh.meshlets });
+    header.meshlet_vertices = writer.write(std::span{ mesh.meshlet_vertices });
+    header.meshlet_triangles = writer.write(std::span{ mesh.meshlet_triangles });
+    writer.finish(header);
+}
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "assets/mesh_data.hpp"
+#include "assets/mesh_format.hpp"
+
+#include <cstdint>
+
+namespace mesh_baker {
+
+void write_mesh_file(const char* filename,
+                     const assets::MeshData& mesh,
+                     assets::VertexFormat vertex_format = assets::VertexFormat::Float32,
+                     uint32_t flags = 0);
+
+}
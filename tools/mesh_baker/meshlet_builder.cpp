@@ -0,0 +1,140 @@
+#include "meshlet_builder.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Cones wider than this (every normal within ~84 degrees of the axis) are never culled.
+constexpr float MIN_CONE_DOT = 0.1f;
+
+// Normal on the side the front face is seen from, given the renderer's clockwise front faces.
+glm::vec3 get_front_normal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+    return glm::cross(p2 - p0, p1 - p0);
+}
+
+void compute_bounds(const assets::MeshData& mesh, assets::Meshlet& meshlet) {
+    glm::vec3 bounds_min{ std::numeric_limits<float>::max() };
+    glm::vec3 bounds_max{ std::numeric_limits<float>::lowest() };
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i) {
+        const glm::vec3& position = mesh.vertices[mesh.meshlet_vertices[meshlet.vertex_offset + i]].position;
+        bounds_min = glm::min(bounds_min, position);
+        bounds_max = glm::max(bounds_max, position);
+    }
+
+    meshlet.center = (bounds_min + bounds_max) * 0.5f;
+    meshlet.radius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i) {
+        const glm::vec3& position = mesh.vertices[mesh.meshlet_vertices[meshlet.vertex_offset + i]].position;
+        meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, position));
+    }
+
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.triangle_count);
+    glm::vec3 normal_sum{ 0.0f };
+    for (uint32_t i = 0; i < meshlet.triangle_count; ++i) {
+        const uint8_t* triangle = &mesh.meshlet_triangles[meshlet.triangle_offset + i * 3];
+        glm::vec3 normal = get_front_normal(mesh.vertices[mesh.meshlet_vertices[meshlet.vertex_offset + triangle[0]]].position,
+                                            mesh.vertices[mesh.meshlet_vertices[meshlet.vertex_offset + triangle[1]]].position,
+                                            mesh.vertices[mesh.meshlet_vertices[meshlet.vertex_offset + triangle[2]]].position);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            normal_sum += normals.back();
+        }
+    }
+
+    // Degenerate cones get an unreachable cutoff instead.
+    meshlet.cone_axis = glm::vec3{ 0.0f };
+    meshlet.cone_cutoff = 1.0f;
+    float axis_length = glm::length(normal_sum);
+    if (axis_length == 0.0f) {
+        return;
+    }
+
+    glm::vec3 axis = normal_sum / axis_length;
+    float min_dot = 1.0f;
+    for (const auto& normal : normals) {
+        min_dot = std::min(min_dot, glm::dot(normal, axis));
+    }
+    if (min_dot <= MIN_CONE_DOT) {
+        return;
+    }
+
+    meshlet.cone_axis = axis;
+    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+}
+
+void build_lod_meshlets(assets::MeshData& mesh, size_t index_offset, size_t index_count, std::vector<uint8_t>& local_indices) {
+    assets::Meshlet meshlet = {};
+    meshlet.vertex_offset = static_cast<uint32_t>(mesh.meshlet_vertices.size());
+    meshlet.triangle_offset = static_cast<uint32_t>(mesh.meshlet_triangles.size());
+
+    auto finish_meshlet = [&] {
+        if (meshlet.triangle_count == 0) {
+            return;
+        }
+
+        compute_bounds(mesh, meshlet);
+        mesh.meshlets.push_back(meshlet);
+        for (uint32_t i = 0; i < meshlet.vertex_count; ++i) {
+            local_indices[mesh.meshlet_vertices[meshlet.vertex_offset + i]] = 0xFF;
+        }
+        mesh.meshlet_triangles.resize((mesh.meshlet_triangles.size() + 3) & ~size_t{ 3 }, 0);
+
+        meshlet = {};
+        meshlet.vertex_offset = static_cast<uint32_t>(mesh.meshlet_vertices.size());
+        meshlet.triangle_offset = static_cast<uint32_t>(mesh.meshlet_triangles.size());
+    };
+
+    for (size_t i = index_offset; i + 2 < index_offset + index_count; i += 3) {
+        const uint32_t* triangle = &mesh.indices[i];
+        uint32_t new_vertex_count = 0;
+        for (uint32_t k = 0; k < 3; ++k) {
+            bool seen_in_triangle = std::find(triangle, triangle + k, triangle[k]) != triangle + k;
+            new_vertex_count += local_indices[triangle[k]] == 0xFF && !seen_in_triangle;
+        }
+        if (meshlet.vertex_count + new_vertex_count > assets::MESHLET_MAX_VERTICES ||
+            meshlet.triangle_count + 1 > assets::MESHLET_MAX_TRIANGLES) {
+            finish_meshlet();
+        }
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            uint8_t& local_index = local_indices[triangle[k]];
+            if (local_index == 0xFF) {
+                local_index = static_cast<uint8_t>(meshlet.vertex_count++);
+                mesh.meshlet_vertices.push_back(triangle[k]);
+            }
+            mesh.meshlet_triangles.push_back(local_index);
+        }
+        ++meshlet.triangle_count;
+    }
+    finish_meshlet();
+}
+
+}
+
+namespace mesh_baker {
+
+void build_meshlets(assets::MeshData& mesh) {
+    mesh.meshlets.clear();
+    mesh.meshlet_vertices.clear();
+    mesh.meshlet_triangles.clear();
+
+    // Local index of every vertex in the meshlet being built, or 0xFF when it isn't in it.
+    std::vector<uint8_t> local_indices(mesh.vertices.size(), 0xFF);
+    if (mesh.lods.empty()) {
+        build_lod_meshlets(mesh, 0, mesh.indices.size(), local_indices);
+    }
+    for (auto& lod : mesh.lods) {
+        lod.meshlet_offset = static_cast<uint32_t>(mesh.meshlets.size());
+        build_lod_meshlets(mesh, lod.index_offset, lod.index_count, local_indices);
+        lod.meshlet_count = static_cast<uint32_t>(mesh.meshlets.size()) - lod.meshlet_offset;
+    }
+}
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "assets/mesh_data.hpp"
+
+namespace mesh_baker {
+
+// Splits the index buffer into meshlets in index order, so it should run after the
+// cache optimizer has grouped neighbouring triangles. Fills the meshlet fields of mesh
+// and the meshlet range of every LOD, each LOD getting meshlets of its own.
+void build_meshlets(assets::MeshData& mesh);
+
+}
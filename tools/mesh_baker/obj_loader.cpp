@@ -0,0 +1,159 @@
+#include "obj_loader.hpp"
+
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+struct VertexKey {
+    int32_t position;
+    int32_t uv;
+    int32_t normal;
+
+    bool operator==(const VertexKey&) const = default;
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const noexcept {
+        size_t hash = std::hash<int32_t>{}(key.position);
+        hash = hash * 31 + std::hash<int32_t>{}(key.uv);
+        hash = hash * 31 + std::hash<int32_t>{}(key.normal);
+        return hash;
+    }
+};
+
+std::string_view next_token(std::string_view& line) {
+    size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+
+    size_t end = line.find_first_of(" \t\r", begin);
+    std::string_view token = line.substr(begin, end - begin);
+    line = end == std::string_view::npos ? std::string_view{} : line.substr(end);
+    return token;
+}
+
+float parse_float(std::string_view token) {
+    float value = 0.0f;
+    std::from_chars(token.data(), token.data() + token.size(), value);
+    return value;
+}
+
+// OBJ indices are 1-based, negative ones count back from the last element.
+int32_t resolve_index(std::string_view token, size_t count) {
+    int32_t index = 0;
+    if (token.empty() || std::from_chars(token.data(), token.data() + token.size(), index).ec != std::errc{}) {
+        return -1;
+    }
+
+    int32_t resolved = index < 0 ? static_cast<int32_t>(count) + index : index - 1;
+    if (resolved < 0 || resolved >= static_cast<int32_t>(count)) {
+        throw std::runtime_error(std::format("OBJ index out of range: {}", index));
+    }
+    return resolved;
+}
+
+}
+
+namespace mesh_baker {
+
+assets::MeshData load_obj(const char* filename) {
+    std::ifstream file{ filename };
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file: {}", filename));
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+
+    assets::MeshData mesh;
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertex_lookup;
+    std::vector<uint32_t> face;
+
+    std::string line_storage;
+    while (std::getline(file, line_storage)) {
+        std::string_view line = line_storage;
+        std::string_view type = next_token(line);
+
+        if (type == "v") {
+            glm::vec3 position;
+            for (int i = 0; i < 3; ++i) {
+                position[i] = parse_float(next_token(line));
+            }
+            positions.push_back(position);
+
+            glm::vec3 color{ 1.0f };
+            if (std::string_view token = next_token(line); !token.empty()) {
+                color.r = parse_float(token);
+                color.g = parse_float(next_token(line));
+                color.b = parse_float(next_token(line));
+            }
+            colors.push_back(color);
+        }
+        else if (type == "vn") {
+            glm::vec3 normal;
+            for (int i = 0; i < 3; ++i) {
+                normal[i] = parse_float(next_token(line));
+            }
+            normals.push_back(normal);
+        }
+        else if (type == "vt") {
+            glm::vec2 uv;
+            uv.x = parse_float(next_token(line));
+            uv.y = 1.0f - parse_float(next_token(line));
+            uvs.push_back(uv);
+        }
+        else if (type == "f") {
+            face.clear();
+            for (std::string_view token = next_token(line); !token.empty(); token = next_token(line)) {
+                size_t first_slash = token.find('/');
+                size_t second_slash = first_slash == std::string_view::npos ? first_slash : token.find('/', first_slash + 1);
+
+                VertexKey key = {
+                    .position = resolve_index(token.substr(0, first_slash), positions.size()),
+                    .uv = first_slash == std::string_view::npos ? -1 :
+                          resolve_index(token.substr(first_slash + 1, second_slash - first_slash - 1), uvs.size()),
+                    .normal = second_slash == std::string_view::npos ? -1 :
+                              resolve_index(token.substr(second_slash + 1), normals.size())
+                };
+                if (key.position < 0) {
+                    throw std::runtime_error(std::format("Face without a position in: {}", filename));
+                }
+
+                auto [it, inserted] = vertex_lookup.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    mesh.vertices.push_back({
+                        .position = positions[key.position],
+                        .normal = key.normal >= 0 ? normals[key.normal] : glm::vec3{ 0.0f },
+                        .uv = key.uv >= 0 ? uvs[key.uv] : glm::vec2{ 0.0f },
+                        .color = colors[key.position]
+                    });
+                }
+                face.push_back(it->second);
+            }
+
+            for (size_t i = 2; i < face.size(); ++i) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[i - 1]);
+                mesh.indices.push_back(face[i]);
+            }
+        }
+    }
+
+    if (mesh.indices.empty()) {
+        throw std::runtime_error(std::format("No faces found in: {}", filename));
+    }
+
+    return mesh;
+}
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "assets/mesh_data.hpp"
+
+namespace mesh_baker {
+
+// Loads positions, normals, texture coordinates and per-vertex colors
+// ("v x y z r g b") from a Wavefront OBJ file. Polygons are fan-triangulated
+// and identical position/uv/normal triplets are merged.
+assets::MeshData load_obj(const char* filename);
+
+}
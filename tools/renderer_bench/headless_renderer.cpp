@@ -0,0 +1,329 @@
+#include "headless_renderer.hpp"
+#include "assets/shader_reflection.hpp"
+#include "common/headless_device.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer_bench {
+
+namespace {
+
+constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t TIMESTAMPS_PER_FRAME = 2;
+
+constexpr const char* SHADER_ARCHIVE_FILENAME = "shaders/shaders.vsha";
+constexpr const char* PERMUTATION_NAME = "simple";
+
+constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+// Same frame buffer layout as the application: FrameConstants, then the instances, then
+// the instance indices of every batch.
+constexpr VkDeviceSize FRAME_INSTANCES_OFFSET = 256;
+
+struct FrameConstants {
+    glm::mat4 view_projection;
+    glm::vec4 camera_position;
+};
+static_assert(sizeof(FrameConstants) <= FRAME_INSTANCES_OFFSET);
+
+// simple.slang's DrawConstants.
+struct DrawConstants {
+    VkDeviceAddress frame;
+    VkDeviceAddress instances;
+    VkDeviceAddress instance_indices;
+    uint64_t padding;
+    glm::vec4 position_offset;
+    glm::vec4 position_scale;
+};
+
+const VkApplicationInfo app_info = tools::get_headless_app_info("Renderer Bench");
+
+const std::array<assets::VertexAttributeSource, 2> vertex_sources = { {
+    { .location = 0, .binding = 0, .offset = offsetof(assets::MeshVertex, position) },
+    { .location = 1, .binding = 0, .offset = offsetof(assets::MeshVertex, color) }
+} };
+
+}
+
+HeadlessRenderer::HeadlessRenderer(VkExtent2D extent, size_t object_count, uint32_t frame_count) :
+    instance_{ app_info, {}, {} },
+    device_{ tools::create_headless_device(instance_, queue_family_index_, device_name_) },
+    queue_{ device_.get_queue(queue_family_index_) },
+    cmd_pool_{ device_, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queue_family_index_ },
+    memory_allocator_{ instance_, device_, app_info.apiVersion },
+    shader_archive_{ SHADER_ARCHIVE_FILENAME },
+    extent_{ extent },
+    depth_format_{ choose_depth_format() },
+    color_image_{ memory_allocator_, COLOR_FORMAT, extent_, 1, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT },
+    color_image_view_{ device_, color_image_, COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT },
+    depth_image_{ memory_allocator_, depth_format_, extent_, 1, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT },
+    depth_image_view_{ device_, depth_image_, depth_format_, VK_IMAGE_ASPECT_DEPTH_BIT },
+    shader_module_{ device_, shader_archive_.get_code(shader_archive_.get(PERMUTATION_NAME)) },
+    pipeline_layout_{ assets::create_pipeline_layout(device_, shader_archive_.get_reflection(shader_archive_.get(PERMUTATION_NAME))) },
+    pipeline_{ create_pipeline() },
+    cmd_buffers_{ cmd_pool_.allocate_command_buffers(FRAMES_IN_FLIGHT) }
+{
+    auto reflection = shader_archive_.get_reflection(shader_archive_.get(PERMUTATION_NAME));
+    push_constant_stages_ = reflection.push_constant_ranges.empty() ? 0 : reflection.push_constant_ranges[0].stage_flags;
+
+    const VkDeviceSize frame_buffer_size = FRAME_INSTANCES_OFFSET + object_count * (sizeof(scene::InstanceData) + sizeof(uint32_t));
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+        fences_.emplace_back(device_, true);
+        frame_buffers_.emplace_back(memory_allocator_,
+                                    frame_buffer_size,
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                    vlk::Buffer::DYNAMIC_FLAGS);
+    }
+
+    // Queues without timestamp support only get CPU times.
+    const auto& physical_device = device_.get_physical_device();
+    if (physical_device.get_queue_family_properties()[queue_family_index_].timestampValidBits > 0) {
+        timestamp_pool_.emplace(device_, VK_QUERY_TYPE_TIMESTAMP, FRAMES_IN_FLIGHT * TIMESTAMPS_PER_FRAME);
+        timestamp_period_ = physical_device.get_properties().limits.timestampPeriod;
+        gpu_frame_times_.reserve(frame_count);
+    }
+}
+
+HeadlessRenderer::~HeadlessRenderer() {
+    device_.wait_idle();
+}
+
+VkFormat HeadlessRenderer::choose_depth_format() const {
+    for (VkFormat format : { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D16_UNORM }) {
+        auto props = device_.get_physical_device().get_format_properties(format);
+        if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("Failed to find a supported depth format.");
+}
+
+vlk::Pipeline HeadlessRenderer::create_pipeline() {
+    const auto& shader_entry = shader_archive_.get(PERMUTATION_NAME);
+
+    const std::array<VkPipelineShaderStageCreateInfo, 2> stages = { {
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .module = shader_module_,
+            .pName = "vert_main"
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module = shader_module_,
+            .pName = "frag_main"
+        }
+    } };
+
+    const VkVertexInputBindingDescription vertex_binding_description = {
+        .binding = 0,
+        .stride = sizeof(assets::MeshVertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+
+    auto vertex_attribute_descriptions = assets::create_vertex_attributes(shader_archive_.get_reflection(shader_entry), vertex_sources);
+
+    return { device_,
+             pipeline_layout_,
+             stages,
+             COLOR_FORMAT,
+             vertex_binding_description,
+             vertex_attribute_descriptions,
+             { depth_format_, VK_COMPARE_OP_LESS, true } };
+}
+
+VkDeviceSize HeadlessRenderer::upload_geometry(const SyntheticGeometry& geometry) {
+    const auto vertex_data = std::as_bytes(std::span{ geometry.vertices });
+    const auto index_data = std::as_bytes(std::span{ geometry.indices });
+    meshes_ = geometry.meshes;
+
+    vertex_buffer_.emplace(memory_allocator_,
+                           vertex_data.size(),
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                           vlk::Buffer::UPLOAD_FLAGS);
+    index_buffer_.emplace(memory_allocator_,
+                          index_data.size(),
+                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          vlk::Buffer::UPLOAD_FLAGS);
+
+    // Mapped buffers are written directly, the others go through staging.
+    std::vector<vlk::Buffer> staging_buffers;
+    auto upload_buffer = [&](const vlk::Buffer& buffer, std::span<const std::byte> data) {
+        if (buffer.is_mapped()) {
+            std::memcpy(buffer.get_mapped_span<std::byte>().data(), data.data(), data.size());
+            buffer.flush();
+            return;
+        }
+
+        auto& staging_buffer = staging_buffers.emplace_back(memory_allocator_,
+                                                            buffer.get_size(),
+                                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+        staging_buffer.copy_memory_to_allocation(data.data(), data.size());
+    };
+
+    upload_buffer(*vertex_buffer_, vertex_data);
+    upload_buffer(*index_buffer_, index_data);
+
+    if (!staging_buffers.empty()) {
+        auto staging_cmd_buffers = cmd_pool_.allocate_command_buffers(1);
+
+        auto& staging_cmd_buffer = staging_cmd_buffers[0];
+        staging_cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        if (!vertex_buffer_->is_mapped()) {
+            staging_cmd_buffer.copy_buffer(staging_buffers.front(), *vertex_buffer_);
+        }
+        if (!index_buffer_->is_mapped()) {
+            staging_cmd_buffer.copy_buffer(staging_buffers.back(), *index_buffer_);
+        }
+        staging_cmd_buffer.end();
+
+        queue_.submit(staging_cmd_buffer);
+        queue_.wait_idle();
+
+        cmd_pool_.free_command_buffers(staging_cmd_buffers);
+    }
+
+    return vertex_data.size() + index_data.size();
+}
+
+void HeadlessRenderer::begin_frame() {
+    fences_[frame_number_ % FRAMES_IN_FLIGHT].wait();
+
+    // The frame last submitted from this slot and every one before it are done.
+    if (frame_number_ >= FRAMES_IN_FLIGHT) {
+        read_gpu_timestamps(frame_number_ - FRAMES_IN_FLIGHT + 1);
+    }
+}
+
+VkDeviceSize HeadlessRenderer::render(const SceneFrame& frame) {
+    const uint32_t frame_index = frame_number_ % FRAMES_IN_FLIGHT;
+    const vlk::CommandBuffer& cmd_buffer = cmd_buffers_[frame_index];
+
+    const vlk::Buffer& frame_buffer = frame_buffers_[frame_index];
+    const VkDeviceSize instances_size = frame.instances.size() * sizeof(scene::InstanceData);
+    const VkDeviceSize instance_indices_size = frame.instance_indices.size() * sizeof(uint32_t);
+    const VkDeviceSize frame_size = FRAME_INSTANCES_OFFSET + instances_size + instance_indices_size;
+    if (frame_size > frame_buffer.get_size()) {
+        throw std::runtime_error{ "Frame does not fit the frame buffer." };
+    }
+
+    const auto frame_data = frame_buffer.get_mapped_span<std::byte>();
+    const FrameConstants frame_constants = {
+        .view_projection = frame.view_projection,
+        .camera_position = glm::vec4{ frame.camera_position, 1.0f }
+    };
+    std::memcpy(frame_data.data(), &frame_constants, sizeof(frame_constants));
+    std::memcpy(frame_data.data() + FRAME_INSTANCES_OFFSET, frame.instances.data(), instances_size);
+    std::memcpy(frame_data.data() + FRAME_INSTANCES_OFFSET + instances_size, frame.instance_indices.data(), instance_indices_size);
+    frame_buffer.flush();
+
+    cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    if (timestamp_pool_) {
+        vkCmdResetQueryPool(cmd_buffer, *timestamp_pool_, frame_index * TIMESTAMPS_PER_FRAME, TIMESTAMPS_PER_FRAME);
+        vkCmdWriteTimestamp2(cmd_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, *timestamp_pool_, frame_index * TIMESTAMPS_PER_FRAME);
+    }
+
+    // Frames in flight share the targets, so each waits for the previous one's writes.
+    cmd_buffer.transition_image_layout(color_image_,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    cmd_buffer.transition_image_layout(depth_image_,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                       VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                                       VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                                       { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 });
+
+    cmd_buffer.begin_rendering({ 0.0f, 0.0f, 0.0f, 1.0f }, color_image_view_, extent_, depth_image_view_);
+
+    VkViewport viewport = { 0.0f, 0.0f, static_cast<float>(extent_.width), static_cast<float>(extent_.height), 0.0f, 1.0f };
+    vkCmdSetViewport(cmd_buffer, 0, 1, &viewport);
+    VkRect2D scissor = { { 0, 0 }, extent_ };
+    vkCmdSetScissor(cmd_buffer, 0, 1, &scissor);
+
+    vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+
+    const VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd_buffer, 0, 1, vertex_buffer_->ptr(), &offset);
+    vkCmdBindIndexBuffer(cmd_buffer, *index_buffer_, 0, VK_INDEX_TYPE_UINT32);
+
+    const VkDeviceAddress frame_address = frame_buffer.get_device_address();
+    const VkDeviceAddress instances_address = frame_address + FRAME_INSTANCES_OFFSET;
+    const VkDeviceAddress instance_indices_address = instances_address + instances_size;
+    DrawConstants draw = {
+        .frame = frame_address,
+        .instances = instances_address,
+        .instance_indices = 0,
+        .padding = 0,
+        .position_offset = glm::vec4{ 0.0f },
+        .position_scale = glm::vec4{ 1.0f }
+    };
+
+    // Materials only split batches, the simple pipeline has no material data to bind.
+    for (const scene::DrawBatch& batch : frame.draws) {
+        const SyntheticMesh& mesh = meshes_[batch.mesh];
+        draw.instance_indices = instance_indices_address + batch.first_instance * sizeof(uint32_t);
+        vkCmdPushConstants(cmd_buffer, pipeline_layout_, push_constant_stages_, 0, sizeof(draw), &draw);
+        vkCmdDrawIndexed(cmd_buffer, mesh.index_count, batch.instance_count, mesh.index_offset, mesh.vertex_offset, 0);
+    }
+
+    vkCmdEndRendering(cmd_buffer);
+
+    if (timestamp_pool_) {
+        vkCmdWriteTimestamp2(cmd_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, *timestamp_pool_, frame_index * TIMESTAMPS_PER_FRAME + 1);
+    }
+
+    cmd_buffer.end();
+
+    fences_[frame_index].reset();
+    queue_.submit(cmd_buffer, nullptr, {}, nullptr, &fences_[frame_index]);
+    ++frame_number_;
+
+    return frame_size;
+}
+
+void HeadlessRenderer::finish() {
+    queue_.wait_idle();
+    read_gpu_timestamps(frame_number_);
+}
+
+void HeadlessRenderer::read_gpu_timestamps(uint64_t frame_count) {
+    if (!timestamp_pool_) {
+        return;
+    }
+
+    for (uint64_t frame = gpu_frame_times_.size(); frame < frame_count; ++frame) {
+        std::array<uint64_t, TIMESTAMPS_PER_FRAME> timestamps;
+        timestamp_pool_->get_results((frame % FRAMES_IN_FLIGHT) * TIMESTAMPS_PER_FRAME, timestamps);
+        gpu_frame_times_.push_back(static_cast<double>(timestamps[1] - timestamps[0]) * timestamp_period_ * 1e-6);
+    }
+}
+
+MemoryStats HeadlessRenderer::get_memory_stats() const {
+    VmaTotalStatistics stats;
+    vmaCalculateStatistics(memory_allocator_, &stats);
+
+    return {
+        .allocation_count = stats.total.statistics.allocationCount,
+        .allocation_bytes = stats.total.statistics.allocationBytes,
+        .block_bytes = stats.total.statistics.blockBytes
+    };
+}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "synthetic_scene.hpp"
+#include "assets/shader_archive.hpp"
+#include "utils/non_copyable.hpp"
+#include "vlk/vlk.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace renderer_bench {
+
+struct MemoryStats {
+    uint64_t allocation_count;
+    uint64_t allocation_bytes;
+    // Device memory blocks VMA holds the allocations in.
+    uint64_t block_bytes;
+};
+
+// Draws scene frames into an offscreen color and depth target with the application's
+// simple pipeline, no window or swapchain involved. Every frame in flight has its own
+// command buffer, frame buffer and pair of GPU timestamps.
+class HeadlessRenderer final :
+    NonCopyable {
+public:
+    // GPU times for frame_count frames are reserved up front, so rendering that many
+    // frames never allocates.
+    HeadlessRenderer(VkExtent2D extent, size_t object_count, uint32_t frame_count);
+
+    ~HeadlessRenderer();
+
+    // Uploads the vertices and indices of every mesh, batches refer to them by index.
+    // Returns the bytes uploaded.
+    VkDeviceSize upload_geometry(const SyntheticGeometry& geometry);
+
+    // Waits until the GPU is done with the resources of the next frame.
+    void begin_frame();
+
+    // Records and submits the frame, returns the bytes written to its frame buffer.
+    VkDeviceSize render(const SceneFrame& frame);
+
+    // Waits for every submitted frame.
+    void finish();
+
+    bool has_gpu_timestamps() const noexcept { return timestamp_pool_.has_value(); }
+
+    // Milliseconds between the start and the end of each finished frame on the GPU, in
+    // frame order. Empty when the queue has no timestamps.
+    std::span<const double> get_gpu_frame_times() const noexcept { return gpu_frame_times_; }
+
+    MemoryStats get_memory_stats() const;
+
+    const std::string& get_device_name() const noexcept { return device_name_; }
+private:
+    VkFormat choose_depth_format() const;
+
+    vlk::Pipeline create_pipeline();
+
+    // Reads the timestamps of the finished frames before frame_count.
+    void read_gpu_timestamps(uint64_t frame_count);
+
+    vlk::Instance instance_;
+    uint32_t queue_family_index_ = 0;
+    std::string device_name_;
+    vlk::Device device_;
+    vlk::Queue queue_;
+    vlk::CommandPool cmd_pool_;
+    vlk::MemoryAllocator memory_allocator_;
+    assets::ShaderArchive shader_archive_;
+
+    VkExtent2D extent_;
+    VkFormat depth_format_;
+    vlk::Image color_image_;
+    vlk::ImageView color_image_view_;
+    vlk::Image depth_image_;
+    vlk::ImageView depth_image_view_;
+
+    vlk::ShaderModule shader_module_;
+    vlk::PipelineLayout pipeline_layout_;
+    VkShaderStageFlags push_constant_stages_ = 0;
+    vlk::Pipeline pipeline_;
+
+    std::optional<vlk::Buffer> vertex_buffer_;
+    std::optional<vlk::Buffer> index_buffer_;
+    std::vector<SyntheticMesh> meshes_;
+
+    std::vector<vlk::CommandBuffer> cmd_buffers_;
+    std::vector<vlk::Fence> fences_;
+    std::vector<vlk::Buffer> frame_buffers_;
+
+    std::optional<vlk::QueryPool> timestamp_pool_;
+    float timestamp_period_ = 0.0f;
+    std::vector<double> gpu_frame_times_;
+    uint64_t frame_number_ = 0;
+};
+
+}
@@ -0,0 +1,273 @@
+#include "headless_renderer.hpp"
+#include "synthetic_scene.hpp"
+#include "common/headless_device.hpp"
+#include "jobs/job_system.hpp"
+#include "scene/draw_queue.hpp"
+#include "utils/allocation_counter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Renders a synthetic scene headless for a fixed number of frames and reports frame time
+// percentiles, draw and upload throughput and GPU memory as JSON, so runs can be compared
+// commit over commit. The scene is fully determined by its parameters and the seed, and
+// time advances by a fixed step every frame.
+
+namespace {
+
+struct BenchOptions {
+    renderer_bench::SceneParams scene;
+    uint32_t frame_count = 500;
+    uint32_t warmup_frame_count = 50;
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    // Fails the run when a measured frame makes more heap allocations.
+    uint32_t max_frame_allocations = std::numeric_limits<uint32_t>::max();
+    const char* output_filename = nullptr;
+};
+
+// Seconds of animation per frame.
+constexpr float FRAME_TIME_STEP = 1.0f / 60.0f;
+
+// Returned when there is no Vulkan device to run on, ctest reports the run as skipped.
+constexpr int NO_DEVICE_EXIT_CODE = 77;
+
+constexpr const char* USAGE =
+    "Usage: renderer_bench [--instances N] [--meshes N] [--materials N] [--triangles N] [--frames N]\n"
+    "                      [--warmup N] [--width N] [--height N] [--seed N] [--max-frame-allocations N]\n"
+    "                      [--output file.json]";
+
+struct FrameTimeStats {
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+bool parse_uint(const char* text, uint32_t& value) {
+    const char* end = text + std::strlen(text);
+    auto [ptr, ec] = std::from_chars(text, end, value);
+    return ec == std::errc{} && ptr == end;
+}
+
+bool parse_options(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        const std::string_view name = argv[i];
+        const char* value = argv[i + 1];
+        if (name == "--output") {
+            options.output_filename = value;
+            continue;
+        }
+
+        uint32_t* target = name == "--instances" ? &options.scene.instance_count :
+                           name == "--meshes" ? &options.scene.mesh_count :
+                           name == "--materials" ? &options.scene.material_count :
+                           name == "--triangles" ? &options.scene.triangle_count :
+                           name == "--frames" ? &options.frame_count :
+                           name == "--warmup" ? &options.warmup_frame_count :
+                           name == "--width" ? &options.width :
+                           name == "--height" ? &options.height :
+                           name == "--seed" ? &options.scene.seed :
+                           name == "--max-frame-allocations" ? &options.max_frame_allocations :
+                           nullptr;
+        if (target == nullptr || !parse_uint(value, *target)) {
+            return false;
+        }
+    }
+
+    // Meshes and materials have to fit their draw key fields.
+    return options.scene.instance_count > 0 &&
+           options.scene.mesh_count > 0 && options.scene.mesh_count <= (1u << scene::DRAW_KEY_MESH_BITS) &&
+           options.scene.material_count > 0 && options.scene.material_count <= (1u << scene::DRAW_KEY_MATERIAL_BITS) &&
+           options.frame_count > 0 && options.width > 0 && options.height > 0;
+}
+
+// Nearest-rank percentiles.
+FrameTimeStats get_frame_time_stats(std::span<const double> frame_times) {
+    std::vector<double> sorted{ frame_times.begin(), frame_times.end() };
+    std::ranges::sort(sorted);
+
+    auto percentile = [&](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    };
+
+    return {
+        .mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size()),
+        .p50 = percentile(0.5),
+        .p90 = percentile(0.9),
+        .p99 = percentile(0.99),
+        .max = sorted.back()
+    };
+}
+
+void print_frame_time_stats(std::ostream& out, std::string_view name, std::span<const double> frame_times) {
+    if (frame_times.empty()) {
+        std::println(out, "  \"{}\": null,", name);
+        return;
+    }
+
+    const FrameTimeStats stats = get_frame_time_stats(frame_times);
+    std::println(out, "  \"{}\": {{ \"mean\": {:.4f}, \"p50\": {:.4f}, \"p90\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f} }},",
+                 name, stats.mean, stats.p50, stats.p90, stats.p99, stats.max);
+}
+
+void run(const BenchOptions& options, std::ostream& out) {
+    jobs::JobSystem job_system{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+
+    const uint32_t total_frame_count = options.warmup_frame_count + options.frame_count;
+
+    renderer_bench::SyntheticScene synthetic_scene{ options.scene };
+    renderer_bench::HeadlessRenderer renderer{ { options.width, options.height }, synthetic_scene.get_object_count(), total_frame_count };
+    const auto& meshes = synthetic_scene.get_geometry().meshes;
+
+    auto upload_start = std::chrono::steady_clock::now();
+    const VkDeviceSize geometry_bytes = renderer.upload_geometry(synthetic_scene.get_geometry());
+    const double upload_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - upload_start).count();
+
+    const float aspect_ratio = static_cast<float>(options.width) / static_cast<float>(options.height);
+
+    // CPU times cover simulating, recording and submitting a frame; frame times also include
+    // waiting for the GPU to free the frame's resources.
+    std::vector<double> cpu_frame_times;
+    std::vector<double> frame_times;
+    cpu_frame_times.reserve(options.frame_count);
+    frame_times.reserve(options.frame_count);
+    uint64_t draw_count = 0;
+    uint64_t visible_count = 0;
+    uint64_t triangle_count = 0;
+    uint64_t frame_bytes = 0;
+    // Warmup frames grow the reused frame containers, measured frames should not allocate.
+    uint64_t heap_allocation_count = 0;
+    uint64_t max_frame_heap_allocation_count = 0;
+
+    renderer_bench::SceneFrame frame;
+    synthetic_scene.reserve_frame(frame);
+    std::chrono::steady_clock::time_point measure_start;
+    for (uint32_t i = 0; i < total_frame_count; ++i) {
+        const bool is_measured = i >= options.warmup_frame_count;
+        auto frame_start = std::chrono::steady_clock::now();
+        if (i == options.warmup_frame_count) {
+            measure_start = frame_start;
+        }
+
+        const auto frame_start_allocations = allocation_counter::get_stats();
+        renderer.begin_frame();
+        auto cpu_start = std::chrono::steady_clock::now();
+        synthetic_scene.simulate(static_cast<float>(i) * FRAME_TIME_STEP, aspect_ratio, job_system, frame);
+        const VkDeviceSize written_bytes = renderer.render(frame);
+        auto frame_end = std::chrono::steady_clock::now();
+        const auto frame_allocations = allocation_counter::get_stats() - frame_start_allocations;
+
+        if (is_measured) {
+            cpu_frame_times.push_back(std::chrono::duration<double, std::milli>(frame_end - cpu_start).count());
+            frame_times.push_back(std::chrono::duration<double, std::milli>(frame_end - frame_start).count());
+            draw_count += frame.draws.size();
+            visible_count += frame.culling_stats.visible_count;
+            for (const scene::DrawBatch& batch : frame.draws) {
+                triangle_count += static_cast<uint64_t>(batch.instance_count) * meshes[batch.mesh].index_count / 3;
+            }
+            frame_bytes += written_bytes;
+            heap_allocation_count += frame_allocations.count;
+            max_frame_heap_allocation_count = std::max(max_frame_heap_allocation_count, frame_allocations.count);
+        }
+    }
+    renderer.finish();
+    const double measured_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - measure_start).count();
+
+    auto gpu_frame_times = renderer.get_gpu_frame_times();
+    if (!gpu_frame_times.empty()) {
+        gpu_frame_times = gpu_frame_times.subspan(options.warmup_frame_count);
+    }
+
+    const double frame_count = options.frame_count;
+    const auto memory = renderer.get_memory_stats();
+
+    std::println(out, "{{");
+    std::println(out, "  \"device\": \"{}\",", renderer.get_device_name());
+    std::println(out, "  \"scene\": {{ \"instances\": {}, \"meshes\": {}, \"materials\": {}, \"triangles_per_mesh\": {}, \"seed\": {} }},",
+                 options.scene.instance_count, options.scene.mesh_count, options.scene.material_count,
+                 meshes[0].index_count / 3, options.scene.seed);
+    std::println(out, "  \"frames\": {},", options.frame_count);
+    std::println(out, "  \"warmup_frames\": {},", options.warmup_frame_count);
+    std::println(out, "  \"resolution\": [{}, {}],", options.width, options.height);
+    print_frame_time_stats(out, "cpu_frame_ms", cpu_frame_times);
+    print_frame_time_stats(out, "frame_ms", frame_times);
+    print_frame_time_stats(out, "gpu_frame_ms", gpu_frame_times);
+    std::println(out, "  \"draw_calls_per_frame\": {:.1f},", static_cast<double>(draw_count) / frame_count);
+    std::println(out, "  \"visible_instances_per_frame\": {:.1f},", static_cast<double>(visible_count) / frame_count);
+    std::println(out, "  \"triangles_per_frame\": {:.1f},", static_cast<double>(triangle_count) / frame_count);
+    std::println(out, "  \"draw_calls_per_second\": {:.1f},", static_cast<double>(draw_count) / measured_seconds);
+    std::println(out, "  \"triangles_per_second\": {:.1f},", static_cast<double>(triangle_count) / measured_seconds);
+    std::println(out, "  \"upload\": {{ \"geometry_bytes\": {}, \"geometry_bytes_per_second\": {:.1f}, \"frame_bytes_per_frame\": {:.1f}, \"frame_bytes_per_second\": {:.1f} }},",
+                 geometry_bytes, static_cast<double>(geometry_bytes) / upload_seconds,
+                 static_cast<double>(frame_bytes) / frame_count, static_cast<double>(frame_bytes) / measured_seconds);
+    std::println(out, "  \"heap_allocations\": {{ \"per_frame\": {:.2f}, \"max_frame\": {} }},",
+                 static_cast<double>(heap_allocation_count) / frame_count, max_frame_heap_allocation_count);
+    std::println(out, "  \"gpu_memory\": {{ \"allocation_count\": {}, \"allocation_bytes\": {}, \"block_bytes\": {} }}",
+                 memory.allocation_count, memory.allocation_bytes, memory.block_bytes);
+    std::println(out, "}}");
+
+    if (max_frame_heap_allocation_count > options.max_frame_allocations) {
+        throw std::runtime_error{ std::format("A measured frame made {} heap allocations, more than the {} allowed.",
+                                              max_frame_heap_allocation_count, options.max_frame_allocations) };
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        std::println(std::cerr, "{}", USAGE);
+        return 1;
+    }
+
+    VkResult result = volkInitialize();
+    if (result != VK_SUCCESS) {
+        std::println(std::cerr, "Failed to load Vulkan library.");
+        return NO_DEVICE_EXIT_CODE;
+    }
+
+    try {
+        if (options.output_filename != nullptr) {
+            std::ofstream file{ options.output_filename };
+            if (!file) {
+                throw std::runtime_error{ std::format("Failed to open {} for writing.", options.output_filename) };
+            }
+            run(options, file);
+        }
+        else {
+            run(options, std::cout);
+        }
+    }
+    catch (const tools::NoDeviceError& e) {
+        std::println(std::cerr, "{}", e.what());
+        return NO_DEVICE_EXIT_CODE;
+    }
+    catch (const std::exception& e) {
+        std::println(std::cerr, "{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
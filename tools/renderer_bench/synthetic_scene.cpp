@@ -0,0 +1,189 @@
+#include "synthetic_scene.hpp"
+#include "jobs/job_system.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+constexpr uint32_t INSTANCE_JOB_SIZE = 4096;
+
+// Lengths are in unit sphere radii, bumps push meshes out by up to MAX_BUMP_AMPLITUDE.
+constexpr float MAX_BUMP_AMPLITUDE = 0.3f;
+constexpr float OBJECT_SPACING = 4.0f;
+constexpr float MIN_OBJECT_SCALE = 0.5f;
+constexpr float MAX_OBJECT_SCALE = 1.5f;
+// Radians per second.
+constexpr float SPIN_SPEED = 0.5f;
+
+// The camera circles the center inside the scene, so a good part of it is always culled.
+// CAMERA_DISTANCE is in scene radii.
+constexpr float CAMERA_FOV_Y = glm::radians(60.0f);
+constexpr float CAMERA_ELEVATION = glm::radians(25.0f);
+constexpr float CAMERA_DISTANCE = 0.5f;
+constexpr float CAMERA_NEAR = 0.1f;
+constexpr float CAMERA_ORBIT_SPEED = 0.2f;
+
+}
+
+namespace renderer_bench {
+
+SyntheticScene::SyntheticScene(const SceneParams& params) {
+    std::mt19937 rng{ params.seed };
+    generate_meshes(params, rng);
+    generate_objects(params, rng);
+
+    visible_objects_.reserve(params.instance_count);
+    draw_queue_.reserve(params.instance_count);
+}
+
+void SyntheticScene::generate_meshes(const SceneParams& params, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+
+    // A sphere grid of rings x segments quads, two triangles each.
+    const uint32_t segments = std::max(3u, static_cast<uint32_t>(std::sqrt(static_cast<float>(params.triangle_count))));
+    const uint32_t rings = std::max(2u, params.triangle_count / (2 * segments));
+
+    for (uint32_t mesh = 0; mesh < params.mesh_count; ++mesh) {
+        const float bump_frequency = static_cast<float>(2 + mesh % 5);
+        const float bump_amplitude = unit(rng) * MAX_BUMP_AMPLITUDE;
+        const glm::vec3 color = { unit(rng), unit(rng), unit(rng) };
+
+        geometry_.meshes.push_back({
+            .vertex_offset = static_cast<int32_t>(geometry_.vertices.size()),
+            .index_offset = static_cast<uint32_t>(geometry_.indices.size()),
+            .index_count = rings * segments * 6
+        });
+        mesh_radii_.push_back(1.0f + bump_amplitude);
+
+        for (uint32_t ring = 0; ring <= rings; ++ring) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; ++segment) {
+                const float phi = 2.0f * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                const glm::vec3 direction = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                const float radius = 1.0f + bump_amplitude * std::sin(bump_frequency * theta) * std::cos(bump_frequency * phi);
+                geometry_.vertices.push_back({
+                    .position = direction * radius,
+                    .normal = direction,
+                    .uv = { static_cast<float>(segment) / static_cast<float>(segments), static_cast<float>(ring) / static_cast<float>(rings) },
+                    .color = color
+                });
+            }
+        }
+
+        // Counter-clockwise seen from outside.
+        for (uint32_t ring = 0; ring < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                const uint32_t v0 = ring * (segments + 1) + segment;
+                const uint32_t v1 = v0 + 1;
+                const uint32_t v2 = v0 + segments + 1;
+                const uint32_t v3 = v2 + 1;
+                geometry_.indices.insert(geometry_.indices.end(), { v0, v1, v2, v1, v3, v2 });
+            }
+        }
+    }
+}
+
+void SyntheticScene::generate_objects(const SceneParams& params, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+    std::uniform_int_distribution<uint32_t> mesh_distribution{ 0, params.mesh_count - 1 };
+    std::uniform_int_distribution<uint32_t> material_distribution{ 0, params.material_count - 1 };
+
+    // Keeps the density the same for any instance count.
+    const float extent = std::cbrt(static_cast<float>(params.instance_count)) * OBJECT_SPACING;
+    scene_radius_ = std::max(extent * std::sqrt(3.0f) * 0.5f, 1.0f);
+
+    materials_.reserve(params.instance_count);
+    spin_axes_.reserve(params.instance_count);
+    spin_phases_.reserve(params.instance_count);
+    for (uint32_t i = 0; i < params.instance_count; ++i) {
+        const glm::vec3 position = (glm::vec3{ unit(rng), unit(rng), unit(rng) } - 0.5f) * extent;
+        const float scale = MIN_OBJECT_SCALE + unit(rng) * (MAX_OBJECT_SCALE - MIN_OBJECT_SCALE);
+        const uint32_t mesh = mesh_distribution(rng);
+
+        spin_axes_.push_back(glm::normalize(glm::vec3{ unit(rng), unit(rng), unit(rng) } - 0.5f + glm::vec3{ 0.0f, 1e-3f, 0.0f }));
+        spin_phases_.push_back(unit(rng) * 2.0f * std::numbers::pi_v<float>);
+        materials_.push_back(material_distribution(rng));
+
+        const glm::quat rotation = glm::angleAxis(spin_phases_.back(), spin_axes_.back());
+        scene_.add_object({ position, rotation, glm::vec3{ scale } }, { glm::vec3{ 0.0f }, mesh_radii_[mesh] }, mesh);
+    }
+}
+
+void SyntheticScene::reserve_frame(SceneFrame& frame) const {
+    const size_t object_count = scene_.get_object_count();
+    frame.instances.reserve(object_count);
+    frame.instance_indices.reserve(object_count);
+    frame.draws.reserve(object_count);
+}
+
+void SyntheticScene::simulate(float time, float aspect_ratio, jobs::JobSystem& job_system, SceneFrame& frame) {
+    const float distance = CAMERA_DISTANCE * scene_radius_;
+    const float orbit_angle = time * CAMERA_ORBIT_SPEED;
+    const glm::vec3 camera_position = glm::vec3{ std::sin(orbit_angle) * std::cos(CAMERA_ELEVATION),
+                                                 -std::sin(CAMERA_ELEVATION),
+                                                 -std::cos(orbit_angle) * std::cos(CAMERA_ELEVATION) } * distance;
+    glm::mat4 projection = glm::perspectiveRH_ZO(CAMERA_FOV_Y, aspect_ratio, CAMERA_NEAR, distance + scene_radius_);
+    projection[1][1] = -projection[1][1];
+
+    frame.view_projection = projection * glm::lookAtRH(camera_position, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, -1.0f, 0.0f });
+    frame.camera_position = camera_position;
+
+    const auto object_count = static_cast<uint32_t>(scene_.get_object_count());
+    auto animate = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t object = begin; object < end; ++object) {
+            scene_.set_local_rotation(object, glm::angleAxis(time * SPIN_SPEED + spin_phases_[object], spin_axes_[object]));
+        }
+    };
+
+    jobs::Counter animate_counter;
+    job_system.parallel_for(animate_counter, object_count, INSTANCE_JOB_SIZE, animate);
+    job_system.wait(animate_counter);
+
+    frame.instances.resize(object_count);
+    scene_.update(frame.instances, job_system);
+
+    if (!culling_hierarchy_built_) {
+        culling_hierarchy_.build(scene_);
+        culling_hierarchy_built_ = true;
+    }
+    else {
+        culling_hierarchy_.refit(scene_, job_system);
+    }
+    frame.culling_stats = culling_hierarchy_.cull(scene::make_frustum(frame.view_projection), job_system, visible_objects_);
+
+    const auto meshes = scene_.get_meshes();
+    const float max_distance = distance + scene_radius_;
+    const auto visible_count = static_cast<uint32_t>(visible_objects_.size());
+    draw_queue_.reset(visible_count);
+    auto queue_draws = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t object = visible_objects_[i];
+            const glm::vec3 center = {
+                scene_.get_world_centers(0)[object],
+                scene_.get_world_centers(1)[object],
+                scene_.get_world_centers(2)[object]
+            };
+            const scene::DrawKey key = {
+                .pass = 0,
+                .pipeline = 0,
+                .material = materials_[object],
+                .mesh = meshes[object],
+                .lod = 0,
+                .depth = glm::distance(center, camera_position) / max_distance
+            };
+            draw_queue_.set_draw(i, key, object);
+        }
+    };
+
+    jobs::Counter draw_counter;
+    job_system.parallel_for(draw_counter, visible_count, INSTANCE_JOB_SIZE, queue_draws);
+    job_system.wait(draw_counter);
+
+    draw_queue_.build_batches(job_system, frame.instance_indices, frame.draws);
+}
+
+}
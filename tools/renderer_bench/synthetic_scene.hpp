@@ -0,0 +1,92 @@
+#pragma once
+#include "assets/mesh_format.hpp"
+#include "scene/culling.hpp"
+#include "scene/draw_queue.hpp"
+#include "scene/scene.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace jobs {
+
+class JobSystem;
+
+}
+
+namespace renderer_bench {
+
+struct SceneParams {
+    uint32_t instance_count = 16384;
+    uint32_t mesh_count = 16;
+    uint32_t material_count = 8;
+    // Triangles of every mesh, rounded to a whole sphere grid.
+    uint32_t triangle_count = 1024;
+    uint32_t seed = 1;
+};
+
+// A mesh's range of the shared geometry buffers.
+struct SyntheticMesh {
+    int32_t vertex_offset;
+    uint32_t index_offset;
+    uint32_t index_count;
+};
+
+// Every mesh of a scene packed into one vertex and one index buffer.
+struct SyntheticGeometry {
+    std::vector<assets::MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<SyntheticMesh> meshes;
+};
+
+// What the renderer needs to draw one frame, like the application's frame packet.
+struct SceneFrame {
+    glm::mat4 view_projection;
+    glm::vec3 camera_position;
+    std::vector<scene::InstanceData> instances;
+    std::vector<uint32_t> instance_indices;
+    std::vector<scene::DrawBatch> draws;
+    scene::CullingStats culling_stats;
+};
+
+// Randomly placed, spinning copies of bumpy spheres filling a cube, looked at by a camera
+// circling it. The same parameters always give the same scene and the same frames.
+class SyntheticScene final :
+    NonCopyable {
+public:
+    explicit SyntheticScene(const SceneParams& params);
+
+    // Animates the scene to time in seconds, then culls it and queues its draws the way
+    // the application does.
+    void simulate(float time, float aspect_ratio, jobs::JobSystem& job_system, SceneFrame& frame);
+
+    const SyntheticGeometry& get_geometry() const noexcept { return geometry_; }
+
+    size_t get_object_count() const noexcept { return scene_.get_object_count(); }
+
+    // Sizes frame for every object being visible, so simulating into it never allocates.
+    void reserve_frame(SceneFrame& frame) const;
+private:
+    void generate_meshes(const SceneParams& params, std::mt19937& rng);
+
+    void generate_objects(const SceneParams& params, std::mt19937& rng);
+
+    SyntheticGeometry geometry_;
+    std::vector<float> mesh_radii_;
+    scene::Scene scene_;
+    std::vector<uint32_t> materials_;
+    std::vector<glm::vec3> spin_axes_;
+    std::vector<float> spin_phases_;
+    float scene_radius_ = 1.0f;
+
+    scene::CullingHierarchy culling_hierarchy_;
+    bool culling_hierarchy_built_ = false;
+    std::vector<uint32_t> visible_objects_;
+    scene::DrawQueue draw_queue_;
+};
+
+}
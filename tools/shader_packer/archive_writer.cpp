@@ -0,0 +1,114 @@
+#include "archive_writer.hpp"
+#include "spirv_reflection.hpp"
+#include "assets/shader_archive_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+namespace {
+
+std::vector<char> read_file(const std::string& filename) {
+    std::ifstream file{ filename, std::ios::binary };
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file: {}", filename));
+    }
+
+    return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+class BlobWriter {
+public:
+    BlobWriter(const char* filename, uint64_t start_offset) :
+        file_{ filename, std::ios::binary }
+    {
+        if (!file_.is_open()) {
+            throw std::runtime_error(std::format("Failed to open file for writing: {}", filename));
+        }
+
+        offset_ = start_offset;
+        file_.seekp(static_cast<std::streamoff>(offset_));
+    }
+
+    template<typename T>
+    assets::ShaderBlob write(std::span<const T> data) {
+        pad_to(assets::align_shader_blob(offset_));
+
+        assets::ShaderBlob blob = { offset_, data.size_bytes() };
+        file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size_bytes()));
+        offset_ += data.size_bytes();
+        return blob;
+    }
+
+    void finish(const assets::ShaderArchiveHeader& header, std::span<const assets::ShaderArchiveEntry> entries) {
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file_.seekp(static_cast<std::streamoff>(header.entries.offset));
+        file_.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size_bytes()));
+        if (!file_) {
+            throw std::runtime_error{ "Failed to write shader archive." };
+        }
+    }
+private:
+    void pad_to(uint64_t offset) {
+        static constexpr char zeros[assets::SHADER_BLOB_ALIGNMENT] = {};
+        file_.write(zeros, static_cast<std::streamsize>(offset - offset_));
+        offset_ = offset;
+    }
+
+    std::ofstream file_;
+    uint64_t offset_ = 0;
+};
+
+}
+
+namespace shader_packer {
+
+void write_shader_archive(const char* filename, const std::vector<Permutation>& permutations) {
+    assets::ShaderArchiveHeader header = {
+        .magic = assets::SHADER_ARCHIVE_MAGIC,
+        .version = assets::SHADER_ARCHIVE_VERSION,
+        .entry_count = static_cast<uint32_t>(permutations.size()),
+        .reserved = 0,
+        .entries = {
+            .offset = assets::align_shader_blob(sizeof(assets::ShaderArchiveHeader)),
+            .size = permutations.size() * sizeof(assets::ShaderArchiveEntry)
+        }
+    };
+
+    // The entry table is written last, once all blob offsets are known.
+    BlobWriter writer{ filename, header.entries.offset + header.entries.size };
+
+    std::vector<assets::ShaderArchiveEntry> entries;
+    entries.reserve(permutations.size());
+    for (const auto& permutation : permutations) {
+        auto bytes = read_file(permutation.spirv_filename);
+        if (bytes.size() < sizeof(uint32_t) || bytes.size() % sizeof(uint32_t) != 0) {
+            throw std::runtime_error(std::format("Not a valid SPIR-V - {}", permutation.spirv_filename));
+        }
+        std::vector<uint32_t> code(bytes.size() / sizeof(uint32_t));
+        std::memcpy(code.data(), bytes.data(), bytes.size());
+        auto reflection = serialize_reflection(reflect_spirv(code, permutation.name));
+
+        entries.push_back({
+            .key = assets::get_shader_key(permutation.name),
+            .name = writer.write(std::span{ permutation.name }),
+            .code = writer.write(std::span<const uint32_t>{ code }),
+            .reflection = writer.write(std::span<const std::byte>{ reflection })
+        });
+    }
+
+    std::ranges::sort(entries, {}, &assets::ShaderArchiveEntry::key);
+    auto duplicate = std::ranges::adjacent_find(entries, {}, &assets::ShaderArchiveEntry::key);
+    if (duplicate != entries.end()) {
+        throw std::runtime_error{ "Shader permutation names collide, every name must be unique." };
+    }
+
+    writer.finish(header, entries);
+}
+
+}
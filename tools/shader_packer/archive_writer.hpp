@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace shader_packer {
+
+struct Permutation {
+    std::string name;
+    std::string spirv_filename;
+};
+
+void write_shader_archive(const char* filename, const std::vector<Permutation>& permutations);
+
+}
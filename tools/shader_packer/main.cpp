@@ -0,0 +1,28 @@
+#include "archive_writer.hpp"
+
+#include <iostream>
+#include <print>
+#include <stdexcept>
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || (argc - 2) % 2 != 0) {
+        std::println(std::cerr, "Usage: shader_packer <output.vsha> <name> <shader.spv> [<name> <shader.spv> ...]");
+        return 1;
+    }
+
+    try {
+        std::vector<shader_packer::Permutation> permutations;
+        for (int i = 2; i < argc; i += 2) {
+            permutations.push_back({ argv[i], argv[i + 1] });
+        }
+
+        shader_packer::write_shader_archive(argv[1], permutations);
+        std::println("Packed {}: {} permutations.", argv[1], permutations.size());
+    }
+    catch (const std::exception& e) {
+        std::println(std::cerr, "{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
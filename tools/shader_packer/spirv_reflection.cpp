@@ -0,0 +1,443 @@
+#include "spirv_reflection.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+enum Op : uint32_t {
+    OpEntryPoint = 15,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpSpecConstant = 50,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpTypeAccelerationStructureKHR = 5341
+};
+
+enum Decoration : uint32_t {
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationLocation = 30,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35
+};
+
+enum StorageClass : uint32_t {
+    StorageClassUniformConstant = 0,
+    StorageClassInput = 1,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+    StorageClassPhysicalStorageBuffer = 5349
+};
+
+enum ExecutionModel : uint32_t {
+    ExecutionModelVertex = 0,
+    ExecutionModelFragment = 4,
+    ExecutionModelGLCompute = 5,
+    ExecutionModelTaskEXT = 5364,
+    ExecutionModelMeshEXT = 5365
+};
+
+constexpr uint32_t DIM_BUFFER = 5;
+constexpr uint32_t DIM_SUBPASS_DATA = 6;
+constexpr uint32_t IMAGE_SAMPLED_STORAGE = 2;
+
+uint32_t get_stage_flag(uint32_t execution_model) {
+    switch (execution_model) {
+    case ExecutionModelVertex: return assets::SHADER_STAGE_VERTEX;
+    case ExecutionModelFragment: return assets::SHADER_STAGE_FRAGMENT;
+    case ExecutionModelGLCompute: return assets::SHADER_STAGE_COMPUTE;
+    case ExecutionModelTaskEXT: return assets::SHADER_STAGE_TASK;
+    case ExecutionModelMeshEXT: return assets::SHADER_STAGE_MESH;
+    default: return 0;
+    }
+}
+
+// Number of words taken by a nul-terminated literal string.
+size_t get_string_words(std::span<const uint32_t> words) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if ((words[i] & 0xFF000000u) == 0) {
+            return i + 1;
+        }
+    }
+
+    return words.size();
+}
+
+class Module {
+public:
+    Module(std::span<const uint32_t> code, const std::string& name) :
+        name_{ name }
+    {
+        if (code.size() < SPIRV_HEADER_WORDS || code[0] != SPIRV_MAGIC) {
+            fail("not a valid SPIR-V");
+        }
+
+        for (size_t offset = SPIRV_HEADER_WORDS; offset < code.size();) {
+            uint32_t word_count = code[offset] >> 16;
+            if (word_count == 0 || offset + word_count > code.size()) {
+                fail("truncated instruction");
+            }
+
+            parse(code.subspan(offset, word_count));
+            offset += word_count;
+        }
+    }
+
+    const std::string& get_name() const noexcept { return name_; }
+
+    uint32_t get_stage_flags() const noexcept { return stage_flags_; }
+
+    // Stages listing the variable in their interface. Before SPIR-V 1.4 only inputs and
+    // outputs are listed, so anything else counts as used by every stage.
+    uint32_t get_variable_stages(uint32_t id) const {
+        auto it = variable_stages_.find(id);
+        return it != variable_stages_.end() ? it->second : stage_flags_;
+    }
+
+    const std::unordered_map<uint32_t, std::span<const uint32_t>>& get_variables() const noexcept { return variables_; }
+
+    std::span<const uint32_t> get_type(uint32_t id) const {
+        auto it = types_.find(id);
+        if (it == types_.end()) {
+            fail(std::format("unknown type %{}", id));
+        }
+
+        return it->second;
+    }
+
+    const uint32_t* find_decoration(uint32_t id, uint32_t decoration) const noexcept {
+        auto it = decorations_.find(key(id, decoration));
+        return it != decorations_.end() ? &it->second : nullptr;
+    }
+
+    const uint32_t* find_member_decoration(uint32_t id, uint32_t member, uint32_t decoration) const noexcept {
+        auto it = member_decorations_.find(member_key(id, member, decoration));
+        return it != member_decorations_.end() ? &it->second : nullptr;
+    }
+
+    uint32_t get_constant(uint32_t id) const {
+        auto it = constants_.find(id);
+        if (it == constants_.end()) {
+            fail(std::format("array length %{} is not a constant", id));
+        }
+
+        return it->second;
+    }
+
+    // Size in bytes as laid out in a buffer, honoring explicit strides.
+    uint32_t get_type_size(uint32_t id, uint32_t matrix_stride = 0) const {
+        auto type = get_type(id);
+        switch (type[0] & 0xFFFF) {
+        case OpTypeBool:
+            return 4;
+        case OpTypeInt:
+        case OpTypeFloat:
+            return type[2] / 8;
+        case OpTypeVector:
+            return type[3] * get_type_size(type[2]);
+        case OpTypeMatrix:
+            return type[3] * (matrix_stride != 0 ? matrix_stride : get_type_size(type[2]));
+        case OpTypeArray: {
+            const uint32_t* stride = find_decoration(id, DecorationArrayStride);
+            return get_constant(type[3]) * (stride ? *stride : get_type_size(type[2], matrix_stride));
+        }
+        case OpTypeRuntimeArray:
+            return 0;
+        case OpTypePointer:
+            // Buffer device addresses, e.g. in push constants.
+            if (type[2] == StorageClassPhysicalStorageBuffer) {
+                return 8;
+            }
+            fail(std::format("pointer %{} has no size", id));
+        case OpTypeStruct: {
+            uint32_t size = 0;
+            for (uint32_t member = 0; member + 2 < type.size(); ++member) {
+                const uint32_t* offset = find_member_decoration(id, member, DecorationOffset);
+                const uint32_t* stride = find_member_decoration(id, member, DecorationMatrixStride);
+                size = std::max(size, (offset ? *offset : 0) + get_type_size(type[member + 2], stride ? *stride : 0));
+            }
+            return size;
+        }
+        default:
+            fail(std::format("type %{} has no size", id));
+        }
+    }
+
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw std::runtime_error(std::format("Failed to reflect {}: {}", name_, reason));
+    }
+private:
+    static uint64_t key(uint32_t id, uint32_t value) noexcept { return (uint64_t{ value } << 32) | id; }
+
+    // Member indices and decorations both fit in 16 bits in practice.
+    static uint64_t member_key(uint32_t id, uint32_t member, uint32_t decoration) noexcept {
+        return (uint64_t{ decoration & 0xFFFF } << 48) | (uint64_t{ member & 0xFFFF } << 32) | id;
+    }
+
+    void parse(std::span<const uint32_t> instruction) {
+        uint32_t opcode = instruction[0] & 0xFFFF;
+        switch (opcode) {
+        case OpEntryPoint: {
+            if (instruction.size() < 4) {
+                fail("malformed entry point");
+            }
+            uint32_t stage_flag = get_stage_flag(instruction[1]);
+            stage_flags_ |= stage_flag;
+
+            size_t interface_start = 3 + get_string_words(instruction.subspan(3));
+            for (size_t i = interface_start; i < instruction.size(); ++i) {
+                variable_stages_[instruction[i]] |= stage_flag;
+            }
+            break;
+        }
+        case OpTypeBool:
+        case OpTypeInt:
+        case OpTypeFloat:
+        case OpTypeVector:
+        case OpTypeMatrix:
+        case OpTypeImage:
+        case OpTypeSampler:
+        case OpTypeSampledImage:
+        case OpTypeArray:
+        case OpTypeRuntimeArray:
+        case OpTypeStruct:
+        case OpTypePointer:
+        case OpTypeAccelerationStructureKHR:
+            if (instruction.size() < 2) {
+                fail("malformed type");
+            }
+            types_[instruction[1]] = instruction;
+            break;
+        case OpConstant:
+        case OpSpecConstant:
+            if (instruction.size() >= 4) {
+                constants_[instruction[2]] = instruction[3];
+            }
+            break;
+        case OpVariable:
+            if (instruction.size() < 4) {
+                fail("malformed variable");
+            }
+            variables_[instruction[2]] = instruction;
+            break;
+        case OpDecorate:
+            if (instruction.size() >= 3) {
+                decorations_[key(instruction[1], instruction[2])] = instruction.size() >= 4 ? instruction[3] : 0;
+            }
+            break;
+        case OpMemberDecorate:
+            if (instruction.size() >= 4) {
+                member_decorations_[member_key(instruction[1], instruction[2], instruction[3])] =
+                    instruction.size() >= 5 ? instruction[4] : 0;
+            }
+            break;
+        }
+    }
+
+    std::string name_;
+    uint32_t stage_flags_ = 0;
+    std::unordered_map<uint32_t, uint32_t> variable_stages_;
+    std::unordered_map<uint32_t, std::span<const uint32_t>> types_;
+    std::unordered_map<uint32_t, std::span<const uint32_t>> variables_;
+    std::unordered_map<uint32_t, uint32_t> constants_;
+    std::unordered_map<uint64_t, uint32_t> decorations_;
+    std::unordered_map<uint64_t, uint32_t> member_decorations_;
+};
+
+assets::ReflectedVertexInput reflect_vertex_input(const Module& module, uint32_t location, uint32_t type_id) {
+    auto type = module.get_type(type_id);
+    uint32_t component_count = 1;
+    if ((type[0] & 0xFFFF) == OpTypeVector) {
+        component_count = type[3];
+        type = module.get_type(type[2]);
+    }
+
+    assets::ShaderComponentType component_type;
+    switch (type[0] & 0xFFFF) {
+    case OpTypeInt:
+        component_type = type[3] != 0 ? assets::ShaderComponentType::Sint : assets::ShaderComponentType::Uint;
+        break;
+    case OpTypeFloat:
+        component_type = assets::ShaderComponentType::Float;
+        break;
+    default:
+        module.fail(std::format("vertex input at location {} is not a scalar or vector", location));
+    }
+    if (type[2] != 32) {
+        module.fail(std::format("vertex input at location {} is not 32-bit", location));
+    }
+
+    return {
+        .location = location,
+        .component_type = component_type,
+        .component_count = component_count,
+        .reserved = 0
+    };
+}
+
+assets::ShaderDescriptorType get_descriptor_type(const Module& module, uint32_t storage_class, uint32_t type_id) {
+    auto type = module.get_type(type_id);
+    switch (storage_class) {
+    case StorageClassUniform:
+        return module.find_decoration(type_id, DecorationBufferBlock) ?
+            assets::ShaderDescriptorType::StorageBuffer : assets::ShaderDescriptorType::UniformBuffer;
+    case StorageClassStorageBuffer:
+        return assets::ShaderDescriptorType::StorageBuffer;
+    case StorageClassUniformConstant:
+        break;
+    default:
+        module.fail(std::format("unsupported storage class {} for a descriptor", storage_class));
+    }
+
+    switch (type[0] & 0xFFFF) {
+    case OpTypeSampler:
+        return assets::ShaderDescriptorType::Sampler;
+    case OpTypeSampledImage:
+        return module.get_type(type[2])[3] == DIM_BUFFER ?
+            assets::ShaderDescriptorType::UniformTexelBuffer : assets::ShaderDescriptorType::CombinedImageSampler;
+    case OpTypeImage:
+        if (type[3] == DIM_SUBPASS_DATA) {
+            return assets::ShaderDescriptorType::InputAttachment;
+        }
+        if (type[3] == DIM_BUFFER) {
+            return type[7] == IMAGE_SAMPLED_STORAGE ?
+                assets::ShaderDescriptorType::StorageTexelBuffer : assets::ShaderDescriptorType::UniformTexelBuffer;
+        }
+        return type[7] == IMAGE_SAMPLED_STORAGE ?
+            assets::ShaderDescriptorType::StorageImage : assets::ShaderDescriptorType::SampledImage;
+    case OpTypeAccelerationStructureKHR:
+        return assets::ShaderDescriptorType::AccelerationStructure;
+    default:
+        module.fail(std::format("unsupported descriptor type %{}", type_id));
+    }
+}
+
+}
+
+namespace shader_packer {
+
+ReflectionData reflect_spirv(std::span<const uint32_t> code, const std::string& name) {
+    Module module{ code, name };
+
+    ReflectionData reflection;
+    reflection.stage_flags = module.get_stage_flags();
+    assets::ReflectedPushConstantRange push_constants = { .stage_flags = 0, .offset = UINT32_MAX, .size = 0, .reserved = 0 };
+
+    for (const auto& [id, variable] : module.get_variables()) {
+        auto pointer = module.get_type(variable[1]);
+        if ((pointer[0] & 0xFFFF) != OpTypePointer) {
+            module.fail(std::format("variable %{} is not a pointer", id));
+        }
+        uint32_t storage_class = variable[3];
+        uint32_t type_id = pointer[3];
+        uint32_t stages = module.get_variable_stages(id);
+
+        if (storage_class == StorageClassInput) {
+            const uint32_t* location = module.find_decoration(id, DecorationLocation);
+            if ((stages & assets::SHADER_STAGE_VERTEX) && location && !module.find_decoration(id, DecorationBuiltIn)) {
+                reflection.vertex_inputs.push_back(reflect_vertex_input(module, *location, type_id));
+            }
+            continue;
+        }
+
+        // All push constant blocks end up in one range visible to every stage using any of them.
+        if (storage_class == StorageClassPushConstant) {
+            auto type = module.get_type(type_id);
+            uint32_t begin = UINT32_MAX;
+            for (uint32_t member = 0; member + 2 < type.size(); ++member) {
+                const uint32_t* offset = module.find_member_decoration(type_id, member, DecorationOffset);
+                begin = std::min(begin, offset ? *offset : 0);
+            }
+            uint32_t end = module.get_type_size(type_id);
+            if (begin < end) {
+                uint32_t range_end = std::max(end, push_constants.offset != UINT32_MAX ? push_constants.offset + push_constants.size : 0);
+                push_constants.offset = std::min(push_constants.offset, begin);
+                push_constants.size = range_end - push_constants.offset;
+                push_constants.stage_flags |= stages;
+            }
+            continue;
+        }
+
+        const uint32_t* set = module.find_decoration(id, DecorationDescriptorSet);
+        const uint32_t* binding = module.find_decoration(id, DecorationBinding);
+        if (!set || !binding) {
+            continue;
+        }
+
+        uint32_t count = 1;
+        auto type = module.get_type(type_id);
+        if ((type[0] & 0xFFFF) == OpTypeArray) {
+            count = module.get_constant(type[3]);
+            type_id = type[2];
+        }
+        else if ((type[0] & 0xFFFF) == OpTypeRuntimeArray) {
+            count = 0;
+            type_id = type[2];
+        }
+
+        reflection.descriptor_bindings.push_back({
+            .set = *set,
+            .binding = *binding,
+            .type = get_descriptor_type(module, storage_class, type_id),
+            .count = count,
+            .stage_flags = stages,
+            .reserved = 0
+        });
+    }
+
+    if (push_constants.stage_flags != 0) {
+        reflection.push_constant_ranges.push_back(push_constants);
+    }
+
+    std::ranges::sort(reflection.vertex_inputs, {}, &assets::ReflectedVertexInput::location);
+    std::ranges::sort(reflection.descriptor_bindings, [](const auto& lhs, const auto& rhs) {
+        return lhs.set != rhs.set ? lhs.set < rhs.set : lhs.binding < rhs.binding;
+    });
+
+    return reflection;
+}
+
+std::vector<std::byte> serialize_reflection(const ReflectionData& reflection) {
+    const assets::ShaderReflectionHeader header = {
+        .stage_flags = reflection.stage_flags,
+        .vertex_input_count = static_cast<uint32_t>(reflection.vertex_inputs.size()),
+        .push_constant_range_count = static_cast<uint32_t>(reflection.push_constant_ranges.size()),
+        .descriptor_binding_count = static_cast<uint32_t>(reflection.descriptor_bindings.size())
+    };
+
+    std::vector<std::byte> bytes;
+    auto append = [&bytes](std::span<const std::byte> data) {
+        bytes.insert(bytes.end(), data.begin(), data.end());
+    };
+    append(std::as_bytes(std::span{ &header, 1 }));
+    append(std::as_bytes(std::span{ reflection.vertex_inputs }));
+    append(std::as_bytes(std::span{ reflection.push_constant_ranges }));
+    append(std::as_bytes(std::span{ reflection.descriptor_bindings }));
+
+    return bytes;
+}
+
+}
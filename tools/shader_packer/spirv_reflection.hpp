@@ -0,0 +1,24 @@
+#pragma once
+#include "assets/shader_archive_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace shader_packer {
+
+struct ReflectionData {
+    uint32_t stage_flags = 0;
+    std::vector<assets::ReflectedVertexInput> vertex_inputs;
+    std::vector<assets::ReflectedPushConstantRange> push_constant_ranges;
+    std::vector<assets::ReflectedDescriptorBinding> descriptor_bindings;
+};
+
+// Throws on malformed SPIR-V and on interfaces the renderer can't describe.
+ReflectionData reflect_spirv(std::span<const uint32_t> code, const std::string& name);
+
+std::vector<std::byte> serialize_reflection(const ReflectionData& reflection);
+
+}
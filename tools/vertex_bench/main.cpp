@@ -0,0 +1,135 @@
+#include "assets/mesh_format.hpp"
+#include "assets/vertex_quantization.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Compares the float and quantized vertex layouts: bytes per vertex, CPU memory bandwidth
+// while streaming the buffer and decoding the position and color simple.slang reads the
+// way its vertex inputs do, and the precision lost to quantization. Nothing runs on the
+// GPU, so the timings show how much less memory is read, not vertex fetch throughput.
+
+namespace {
+
+constexpr uint32_t DEFAULT_VERTEX_COUNT = 1 << 20;
+constexpr uint32_t PASS_COUNT = 32;
+
+std::vector<assets::MeshVertex> generate_vertices(uint32_t count) {
+    std::mt19937 rng{ 42 };
+    std::uniform_real_distribution<float> unit{ -1.0f, 1.0f };
+
+    std::vector<assets::MeshVertex> vertices(count);
+    for (auto& vertex : vertices) {
+        glm::vec3 direction = glm::normalize(glm::vec3{ unit(rng), unit(rng), unit(rng) } + glm::vec3{ 1e-3f });
+        vertex.position = direction * (10.0f + unit(rng));
+        vertex.normal = direction;
+        vertex.uv = { unit(rng) * 0.5f + 0.5f, unit(rng) * 0.5f + 0.5f };
+        vertex.color = { unit(rng) * 0.5f + 0.5f, unit(rng) * 0.5f + 0.5f, unit(rng) * 0.5f + 0.5f };
+    }
+
+    return vertices;
+}
+
+// Runs fetch over every vertex PASS_COUNT times and returns the best pass in seconds.
+template<typename Fetch>
+double time_passes(size_t vertex_count, Fetch&& fetch, float& checksum) {
+    double best = std::numeric_limits<double>::max();
+    for (uint32_t pass = 0; pass < PASS_COUNT; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        float sum = 0.0f;
+        for (size_t i = 0; i < vertex_count; ++i) {
+            sum += fetch(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        checksum += sum;
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+
+    return best;
+}
+
+void report(std::string_view name, size_t stride, size_t vertex_count, double seconds) {
+    double megabytes = static_cast<double>(stride * vertex_count) / (1024.0 * 1024.0);
+    std::println("{:<10} {:>3} B/vertex {:>9.2f} MiB {:>8.3f} ms {:>8.2f} GiB/s {:>8.1f} Mvertices/s",
+                 name, stride, megabytes, seconds * 1000.0, megabytes / 1024.0 / seconds, vertex_count / seconds / 1e6);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t vertex_count = DEFAULT_VERTEX_COUNT;
+    if (argc > 2 || (argc == 2 && std::from_chars(argv[1], argv[1] + std::strlen(argv[1]), vertex_count).ec != std::errc{})) {
+        std::println(std::cerr, "Usage: vertex_bench [vertex_count]");
+        return 1;
+    }
+
+    auto vertices = generate_vertices(vertex_count);
+
+    glm::vec3 bounds_min{ std::numeric_limits<float>::max() };
+    glm::vec3 bounds_max{ std::numeric_limits<float>::lowest() };
+    for (const auto& vertex : vertices) {
+        bounds_min = glm::min(bounds_min, vertex.position);
+        bounds_max = glm::max(bounds_max, vertex.position);
+    }
+    auto bounds = assets::get_quantization_bounds(bounds_min, bounds_max);
+
+    std::vector<assets::QuantizedMeshVertex> quantized;
+    quantized.reserve(vertices.size());
+    for (const auto& vertex : vertices) {
+        quantized.push_back(assets::quantize_vertex(vertex, bounds));
+    }
+
+    // Both paths apply position_scale and position_offset like simple.slang, the float
+    // path with the identity the application pushes for it.
+    const assets::QuantizationBounds identity = { .offset = glm::vec3{ 0.0f }, .scale = glm::vec3{ 1.0f } };
+    float checksum = 0.0f;
+    double float_seconds = time_passes(vertices.size(), [&](size_t i) {
+        const auto& vertex = vertices[i];
+        glm::vec3 position = vertex.position * identity.scale + identity.offset;
+        return position.x + position.y + position.z + vertex.color.r + vertex.color.g + vertex.color.b;
+    }, checksum);
+    double quantized_seconds = time_passes(quantized.size(), [&](size_t i) {
+        // R16G16B16A16_SNORM positions and R8G8B8A8_UNORM colors.
+        const auto& vertex = quantized[i];
+        glm::vec3 position{ glm::unpackSnorm1x16(vertex.position[0]),
+                            glm::unpackSnorm1x16(vertex.position[1]),
+                            glm::unpackSnorm1x16(vertex.position[2]) };
+        position = position * bounds.scale + bounds.offset;
+        glm::vec4 color = glm::unpackUnorm4x8(vertex.color);
+        return position.x + position.y + position.z + color.r + color.g + color.b;
+    }, checksum);
+
+    std::println("{} vertices, CPU memory bandwidth, best of {} passes (checksum {:.1f})", vertex_count, PASS_COUNT, checksum);
+    report("float32", sizeof(assets::MeshVertex), vertices.size(), float_seconds);
+    report("quantized", sizeof(assets::QuantizedMeshVertex), quantized.size(), quantized_seconds);
+    std::println("vertex buffer size reduced by {:.1f}%",
+                 100.0 * (1.0 - static_cast<double>(sizeof(assets::QuantizedMeshVertex)) / sizeof(assets::MeshVertex)));
+
+    float max_position_error = 0.0f;
+    float max_normal_error = 0.0f;
+    float max_uv_error = 0.0f;
+    float max_color_error = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        auto decoded = assets::dequantize_vertex(quantized[i], bounds);
+        max_position_error = std::max(max_position_error, glm::length(decoded.position - vertices[i].position));
+        max_normal_error = std::max(max_normal_error, std::acos(std::clamp(glm::dot(decoded.normal, vertices[i].normal), -1.0f, 1.0f)));
+        max_uv_error = std::max(max_uv_error, glm::length(decoded.uv - vertices[i].uv));
+        max_color_error = std::max(max_color_error, glm::length(decoded.color - vertices[i].color));
+    }
+    std::println("max error: position {:.6f} (extent {:.2f}), normal {:.4f} deg, uv {:.6f}, color {:.6f}",
+                 max_position_error, glm::length(bounds_max - bounds_min), glm::degrees(max_normal_error), max_uv_error, max_color_error);
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench_runner.hpp"
+
+#include <algorithm>
+#include <format>
+#include <print>
+#include <stdexcept>
+
+namespace vlk_bench {
+
+namespace {
+
+constexpr double MIN_RUN_SECONDS = 0.25;
+constexpr uint64_t MAX_ITERATIONS = 1'000'000'000;
+
+}
+
+BenchResult run_benchmark(std::string_view name, const BenchFunction& function) {
+    uint64_t iterations = 1;
+    for (;;) {
+        BenchState state{ iterations };
+        function(state);
+        if (!state.is_finished()) {
+            throw std::runtime_error{ std::format("Benchmark {} stopped before running every iteration.", name) };
+        }
+
+        const double seconds = state.get_seconds();
+        if (seconds >= MIN_RUN_SECONDS || iterations >= MAX_ITERATIONS) {
+            const auto count = static_cast<double>(iterations);
+            return {
+                .name = std::string{ name },
+                .iterations = iterations,
+                .nanoseconds = seconds * 1e9 / count,
+                .allocations = static_cast<double>(state.get_allocations().count) / count,
+                .allocated_bytes = static_cast<double>(state.get_allocations().bytes) / count
+            };
+        }
+
+        // Aims a bit past the minimum so the next run is likely the last one.
+        const double scale = seconds > 0.0 ? MIN_RUN_SECONDS * 1.4 / seconds : 100.0;
+        const auto next_iterations = static_cast<uint64_t>(static_cast<double>(iterations) * std::clamp(scale, 2.0, 100.0));
+        iterations = std::min(next_iterations, MAX_ITERATIONS);
+    }
+}
+
+void print_header() {
+    std::println("{:<64} {:>12} {:>12} {:>10} {:>10}", "Benchmark", "Time", "Iterations", "Allocs", "Bytes");
+    std::println("{}", std::string(112, '-'));
+}
+
+void print_result(const BenchResult& result) {
+    std::println("{:<64} {:>9.1f} ns {:>12} {:>10.2f} {:>10.1f}",
+                 result.name, result.nanoseconds, result.iterations, result.allocations, result.allocated_bytes);
+}
+
+}
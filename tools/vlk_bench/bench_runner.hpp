@@ -0,0 +1,75 @@
+#pragma once
+#include "utils/allocation_counter.hpp"
+#include "utils/non_copyable.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace vlk_bench {
+
+// Passed to benchmark bodies the way Google Benchmark does: a body sets up what it needs,
+// then loops while keep_running() returns true. Only the loop is timed and has its
+// allocations counted.
+class BenchState final :
+    NonCopyable {
+public:
+    explicit BenchState(uint64_t iterations) noexcept :
+        iterations_{ iterations } {}
+
+    bool keep_running() noexcept {
+        if (completed_iterations_ == 0 && !running_) {
+            running_ = true;
+            start_allocations_ = allocation_counter::get_stats();
+            start_ = std::chrono::steady_clock::now();
+        }
+
+        if (completed_iterations_ == iterations_) {
+            end_ = std::chrono::steady_clock::now();
+            allocations_ = allocation_counter::get_stats() - start_allocations_;
+            running_ = false;
+            return false;
+        }
+
+        ++completed_iterations_;
+        return true;
+    }
+
+    bool is_finished() const noexcept { return completed_iterations_ == iterations_ && !running_; }
+
+    uint64_t get_iterations() const noexcept { return iterations_; }
+
+    double get_seconds() const noexcept { return std::chrono::duration<double>(end_ - start_).count(); }
+
+    const allocation_counter::AllocationStats& get_allocations() const noexcept { return allocations_; }
+private:
+    uint64_t iterations_;
+    uint64_t completed_iterations_ = 0;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point end_;
+    allocation_counter::AllocationStats start_allocations_;
+    allocation_counter::AllocationStats allocations_;
+};
+
+using BenchFunction = std::function<void(BenchState&)>;
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nanoseconds;
+    double allocations;
+    double allocated_bytes;
+};
+
+// Reruns function with more iterations until the loop takes long enough to time, all
+// numbers are per iteration.
+BenchResult run_benchmark(std::string_view name, const BenchFunction& function);
+
+void print_header();
+
+void print_result(const BenchResult& result);
+
+}
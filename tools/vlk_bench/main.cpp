@@ -0,0 +1,346 @@
+#include "bench_runner.hpp"
+#include "assets/shader_archive.hpp"
+#include "assets/shader_reflection.hpp"
+#include "common/headless_device.hpp"
+#include "vlk/vlk.hpp"
+
+#include <array>
+#include <filesystem>
+#include <iostream>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Microbenchmarks of the vlk wrappers' hot operations on a headless device, next to the
+// raw Vulkan calls they wrap where there is one. Time and heap allocations are per
+// operation, so wrapper overhead shows up as the difference between the two.
+
+namespace {
+
+constexpr const char* SHADER_ARCHIVE_FILENAME = "shaders/shaders.vsha";
+constexpr const char* SHADER_FILENAME = "shaders/simple.spv";
+constexpr const char* PERMUTATION_NAME = "simple";
+
+constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+const VkApplicationInfo app_info = tools::get_headless_app_info("vlk Bench");
+
+// The device renderer_bench uses, with the features the application enables.
+class BenchContext final :
+    NonCopyable {
+public:
+    BenchContext() :
+        instance_{ app_info, {}, {} },
+        device_{ tools::create_headless_device(instance_, queue_family_index_, device_name_) },
+        queue_{ device_.get_queue(queue_family_index_) },
+        memory_allocator_{ instance_, device_, app_info.apiVersion } {}
+
+    ~BenchContext() {
+        device_.wait_idle();
+    }
+
+    const vlk::Device& get_device() const noexcept { return device_; }
+
+    const vlk::Queue& get_queue() const noexcept { return queue_; }
+
+    uint32_t get_queue_family_index() const noexcept { return queue_family_index_; }
+
+    const vlk::MemoryAllocator& get_memory_allocator() const noexcept { return memory_allocator_; }
+
+    const std::string& get_device_name() const noexcept { return device_name_; }
+private:
+    vlk::Instance instance_;
+    uint32_t queue_family_index_ = 0;
+    std::string device_name_;
+    vlk::Device device_;
+    vlk::Queue queue_;
+    vlk::MemoryAllocator memory_allocator_;
+};
+
+struct Benchmark {
+    const char* name;
+    vlk_bench::BenchFunction function;
+};
+
+std::vector<Benchmark> create_benchmarks(const BenchContext& context, const assets::ShaderArchive& shader_archive) {
+    const vlk::Device& device = context.get_device();
+    const vlk::Queue& queue = context.get_queue();
+    const uint32_t queue_family_index = context.get_queue_family_index();
+    const vlk::MemoryAllocator& allocator = context.get_memory_allocator();
+    const auto& shader_entry = shader_archive.get(PERMUTATION_NAME);
+
+    std::vector<Benchmark> benchmarks;
+
+    auto add_allocate_command_buffers = [&](const char* raw_name, const char* name, uint32_t count) {
+        benchmarks.push_back({ raw_name, [&device, queue_family_index, count](vlk_bench::BenchState& state) {
+            const vlk::CommandPool pool{ device, 0, queue_family_index };
+            const VkCommandBufferAllocateInfo alloc_info = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = pool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = count
+            };
+            std::array<VkCommandBuffer, 8> handles;
+            while (state.keep_running()) {
+                vkAllocateCommandBuffers(device, &alloc_info, handles.data());
+                vkFreeCommandBuffers(device, pool, count, handles.data());
+            }
+        } });
+        benchmarks.push_back({ name, [&device, queue_family_index, count](vlk_bench::BenchState& state) {
+            const vlk::CommandPool pool{ device, 0, queue_family_index };
+            std::array<vlk::CommandBuffer, 8> storage;
+            const std::span cmd_buffers{ storage.data(), count };
+            while (state.keep_running()) {
+                pool.allocate_command_buffers(cmd_buffers);
+                pool.free_command_buffers(cmd_buffers);
+            }
+        } });
+    };
+    add_allocate_command_buffers("vkAllocateCommandBuffers+vkFreeCommandBuffers/1",
+                                 "CommandPool::allocate_command_buffers+free_command_buffers/1", 1);
+    add_allocate_command_buffers("vkAllocateCommandBuffers+vkFreeCommandBuffers/8",
+                                 "CommandPool::allocate_command_buffers+free_command_buffers/8", 8);
+
+    benchmarks.push_back({ "CommandBuffer::begin+end", [&device, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::CommandPool pool{ device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        while (state.keep_running()) {
+            cmd_buffers[0].begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            cmd_buffers[0].end();
+        }
+    } });
+
+    benchmarks.push_back({ "CommandBuffer::begin+transition_image_layout+end", [&device, &allocator, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::CommandPool pool{ device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        const vlk::Image image{ allocator, COLOR_FORMAT, { 64, 64 }, 1, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+        while (state.keep_running()) {
+            cmd_buffers[0].begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            cmd_buffers[0].transition_image_layout(image,
+                                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                                   {},
+                                                   VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+            cmd_buffers[0].end();
+        }
+    } });
+
+    // Empty command buffers measure the submission path, not GPU work.
+    benchmarks.push_back({ "vkQueueSubmit+vkWaitForFences+vkResetFences", [&device, &queue, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::CommandPool pool{ device, 0, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        cmd_buffers[0].begin();
+        cmd_buffers[0].end();
+        const vlk::Fence fence{ device };
+        const VkFence fence_handle = fence;
+        const VkSubmitInfo submit_info = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = cmd_buffers[0].ptr()
+        };
+        while (state.keep_running()) {
+            vkQueueSubmit(queue, 1, &submit_info, fence);
+            vkWaitForFences(device, 1, &fence_handle, VK_TRUE, UINT64_MAX);
+            vkResetFences(device, 1, &fence_handle);
+        }
+    } });
+
+    benchmarks.push_back({ "Queue::submit+Fence::wait+Fence::reset", [&device, &queue, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::CommandPool pool{ device, 0, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        cmd_buffers[0].begin();
+        cmd_buffers[0].end();
+        const vlk::Fence fence{ device };
+        while (state.keep_running()) {
+            queue.submit(cmd_buffers[0], nullptr, {}, nullptr, &fence);
+            fence.wait();
+            fence.reset();
+        }
+    } });
+
+    benchmarks.push_back({ "SubmitBatch::flush+Fence::wait+Fence::reset/timeline signal", [&device, &queue, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::CommandPool pool{ device, 0, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        cmd_buffers[0].begin();
+        cmd_buffers[0].end();
+        const vlk::Fence fence{ device };
+        const vlk::Semaphore timeline{ device, 0 };
+        uint64_t value = 0;
+        vlk::SubmitBatch batch;
+        while (state.keep_running()) {
+            batch.add_command_buffer(cmd_buffers[0])
+                 .add_signal(timeline, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, ++value)
+                 .flush(queue, &fence);
+            fence.wait();
+            fence.reset();
+        }
+    } });
+
+    benchmarks.push_back({ "Fence::wait/signaled", [&device](vlk_bench::BenchState& state) {
+        const vlk::Fence fence{ device, true };
+        while (state.keep_running()) {
+            fence.wait();
+        }
+    } });
+
+    benchmarks.push_back({ "Fence::Fence+~Fence", [&device](vlk_bench::BenchState& state) {
+        while (state.keep_running()) {
+            const vlk::Fence fence{ device };
+        }
+    } });
+
+    benchmarks.push_back({ "Semaphore::Semaphore+~Semaphore", [&device](vlk_bench::BenchState& state) {
+        while (state.keep_running()) {
+            const vlk::Semaphore semaphore{ device };
+        }
+    } });
+
+    benchmarks.push_back({ "Buffer::Buffer+~Buffer/256B dynamic", [&allocator](vlk_bench::BenchState& state) {
+        while (state.keep_running()) {
+            const vlk::Buffer buffer{ allocator, 256, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, vlk::Buffer::DYNAMIC_FLAGS };
+        }
+    } });
+
+    benchmarks.push_back({ "Buffer::Buffer+~Buffer/1MiB device address", [&allocator](vlk_bench::BenchState& state) {
+        while (state.keep_running()) {
+            const vlk::Buffer buffer{ allocator,
+                                      1 << 20,
+                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                      vlk::Buffer::UPLOAD_FLAGS };
+        }
+    } });
+
+    benchmarks.push_back({ "Buffer::flush/64KiB", [&allocator](vlk_bench::BenchState& state) {
+        const vlk::Buffer buffer{ allocator, 1 << 16, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, vlk::Buffer::DYNAMIC_FLAGS };
+        while (state.keep_running()) {
+            buffer.flush();
+        }
+    } });
+
+    benchmarks.push_back({ "Image::Image+ImageView::ImageView/256x256", [&device, &allocator](vlk_bench::BenchState& state) {
+        while (state.keep_running()) {
+            const vlk::Image image{ allocator, COLOR_FORMAT, { 256, 256 }, 1, VK_IMAGE_USAGE_SAMPLED_BIT };
+            const vlk::ImageView image_view{ device, image, COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT };
+        }
+    } });
+
+    if (std::filesystem::exists(SHADER_FILENAME)) {
+        benchmarks.push_back({ "ShaderModule::ShaderModule/file", [&device](vlk_bench::BenchState& state) {
+            while (state.keep_running()) {
+                const vlk::ShaderModule shader_module{ device, SHADER_FILENAME };
+            }
+        } });
+    }
+
+    benchmarks.push_back({ "ShaderModule::ShaderModule/code", [&device, &shader_archive, &shader_entry](vlk_bench::BenchState& state) {
+        const auto code = shader_archive.get_code(shader_entry);
+        while (state.keep_running()) {
+            const vlk::ShaderModule shader_module{ device, code };
+        }
+    } });
+
+    benchmarks.push_back({ "ShaderLibrary::load/cached", [&device, &shader_archive, &shader_entry](vlk_bench::BenchState& state) {
+        vlk::ShaderLibrary library{ device };
+        const auto code = shader_archive.get_code(shader_entry);
+        library.load(code);
+        while (state.keep_running()) {
+            library.load(code);
+        }
+    } });
+
+    benchmarks.push_back({ "ResourceRegistry::get_or_create_pipeline/cached", [&device, &shader_archive, &shader_entry](vlk_bench::BenchState& state) {
+        const vlk::ShaderModule shader_module{ device, shader_archive.get_code(shader_entry) };
+        const auto reflection = shader_archive.get_reflection(shader_entry);
+        const vlk::PipelineLayout layout = assets::create_pipeline_layout(device, reflection);
+        const std::array<VkPipelineShaderStageCreateInfo, 2> stages = { {
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                .module = shader_module,
+                .pName = "vert_main"
+            },
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .module = shader_module,
+                .pName = "frag_main"
+            }
+        } };
+        const VkVertexInputBindingDescription binding = {
+            .binding = 0,
+            .stride = 2 * sizeof(float[3]),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        };
+        const std::array<assets::VertexAttributeSource, 2> sources = { {
+            { .location = 0, .binding = 0, .offset = 0 },
+            { .location = 1, .binding = 0, .offset = sizeof(float[3]) }
+        } };
+        const auto attributes = assets::create_vertex_attributes(reflection, sources);
+
+        vlk::ResourceRegistry registry;
+        registry.get_or_create_pipeline(device, layout, stages, COLOR_FORMAT, binding, attributes);
+        while (state.keep_running()) {
+            registry.get_or_create_pipeline(device, layout, stages, COLOR_FORMAT, binding, attributes);
+        }
+    } });
+
+    benchmarks.push_back({ "QueryPool::get_results/2 timestamps", [&device, &queue, queue_family_index](vlk_bench::BenchState& state) {
+        const vlk::QueryPool query_pool{ device, VK_QUERY_TYPE_TIMESTAMP, 2 };
+        const vlk::CommandPool pool{ device, 0, queue_family_index };
+        const auto cmd_buffers = pool.allocate_command_buffers(1);
+        cmd_buffers[0].begin();
+        vkCmdResetQueryPool(cmd_buffers[0], query_pool, 0, 2);
+        vkCmdWriteTimestamp2(cmd_buffers[0], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, query_pool, 0);
+        vkCmdWriteTimestamp2(cmd_buffers[0], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, query_pool, 1);
+        cmd_buffers[0].end();
+        queue.submit(cmd_buffers[0]);
+        queue.wait_idle();
+
+        std::array<uint64_t, 2> results;
+        while (state.keep_running()) {
+            query_pool.get_results(0, results);
+        }
+    } });
+
+    return benchmarks;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        std::println(std::cerr, "Usage: vlk_bench [name_filter]");
+        return 1;
+    }
+    const std::string_view filter = argc == 2 ? argv[1] : "";
+
+    VkResult result = volkInitialize();
+    if (result != VK_SUCCESS) {
+        std::println(std::cerr, "Failed to load Vulkan library.");
+        return 1;
+    }
+
+    try {
+        const BenchContext context;
+        std::println("Device: {}", context.get_device_name());
+        const assets::ShaderArchive shader_archive{ SHADER_ARCHIVE_FILENAME };
+
+        vlk_bench::print_header();
+        for (const Benchmark& benchmark : create_benchmarks(context, shader_archive)) {
+            if (std::string_view{ benchmark.name }.find(filter) != std::string_view::npos) {
+                vlk_bench::print_result(vlk_bench::run_benchmark(benchmark.name, benchmark.function));
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::println(std::cerr, "{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}